@@ -5,7 +5,12 @@
 #include <sstream>
 #include <cstdlib>
 #include <algorithm>
+#include <ctime>
+#include <iomanip>
+#include <chrono>
+#include "batch_search.h"
 #include "curl_downloader.h"
+#include "table_filter.h"
 #include <curl/curl.h>
 
 // Load key=value pairs from .env and set as environment variables
@@ -40,7 +45,10 @@ void printHeader(const std::string& title) {
 }
 
 // Parse command-line arguments
-void parseArgs(int argc, char* argv[], std::string& searchTerm, std::vector<std::string>& qualifiers, int& page) {
+void parseArgs(int argc, char* argv[], std::string& searchTerm, std::vector<std::string>& qualifiers, int& page,
+               int& lastPage, int& count, int& perPage, int& jobs, std::string& fields, std::string& parser, std::string& where,
+               std::string& sort, bool& all, bool& shard, std::string& seen, std::string& batch, int& concurrency,
+               std::string& apiUrl) {
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
         if ((arg == "-s" || arg == "--search") && i + 1 < argc) {
@@ -49,73 +57,346 @@ void parseArgs(int argc, char* argv[], std::string& searchTerm, std::vector<std:
             qualifiers.push_back(argv[++i]);
         } else if ((arg == "-p" || arg == "--page") && i + 1 < argc) {
             page = std::stoi(argv[++i]);
+        } else if ((arg == "-l" || arg == "--last-page") && i + 1 < argc) {
+            lastPage = std::stoi(argv[++i]);
+        } else if ((arg == "-c" || arg == "--count") && i + 1 < argc) {
+            count = std::stoi(argv[++i]);
+        } else if ((arg == "-n" || arg == "--per-page") && i + 1 < argc) {
+            std::string value = argv[++i];
+            perPage = value == "auto" ? CurlDownloader::ADAPTIVE_PER_PAGE : std::stoi(value);
+        } else if ((arg == "-j" || arg == "--jobs") && i + 1 < argc) {
+            jobs = std::stoi(argv[++i]);
+        } else if (arg == "--fields" && i + 1 < argc) {
+            fields = argv[++i];
+        } else if (arg == "--parser" && i + 1 < argc) {
+            parser = argv[++i];
+        } else if (arg == "--where" && i + 1 < argc) {
+            where = argv[++i];
+        } else if (arg == "--sort" && i + 1 < argc) {
+            sort = argv[++i];
+        } else if (arg == "--all") {
+            all = true;
+        } else if (arg == "--shard") {
+            shard = true;
+        } else if (arg == "--seen" && i + 1 < argc) {
+            seen = argv[++i];
+        } else if (arg == "--batch" && i + 1 < argc) {
+            batch = argv[++i];
+        } else if (arg == "--concurrency" && i + 1 < argc) {
+            concurrency = std::stoi(argv[++i]);
+        } else if (arg == "--api-url" && i + 1 < argc) {
+            apiUrl = argv[++i];
         } else if (arg == "-h" || arg == "--help") {
-            std::cout << "Usage: github-searcher -s \"search term\" [-q \"qualifier\"]... [-p page]\n";
+            std::cout << "Usage: github-searcher -s \"search term\" [-q \"qualifier\"]... [-p page] [-l last_page] [-c count] [--all] [--shard] [-n per_page|auto] [-j jobs] [--fields a,b.c,...] [--parser stream|simd|view] [--where filter] [--sort stars|pushed] [--seen file] [--batch file|- [--concurrency n]] [--api-url url]\n";
             std::cout << "Example: github-searcher -s \"cpp web server\" -q \"stars:>500\" -q \"language:C++\"\n";
             exit(0);
         }
     }
 }
 
+// Connection reuse and bytes of session, response buffers over the whole run
+void printTransferStats(const CurlSession& session) {
+    const CurlSession::Stats conn_stats = session.stats();
+    std::cout << "Connections: " << conn_stats.new_connections << " opened, "
+              << conn_stats.reused_connections << " reused over "
+              << conn_stats.transfers << " request(s).\n";
+    std::cout << "Transferred: " << conn_stats.wire_bytes << " bytes on the wire, "
+              << conn_stats.decoded_bytes << " bytes decoded.\n";
+    const ResponseBufferPool::Stats buffer_stats = ResponseBufferPool::global()->stats();
+    std::cout << "Buffers: " << buffer_stats.acquired << " used, " << buffer_stats.recycled << " recycled, "
+              << buffer_stats.allocations << " allocation(s), " << buffer_stats.growths << " while receiving.\n";
+}
+
+// Run every query of a batch file ("-" for stdin), writing results to out as NDJSON
+int runBatch(const std::string& batch, int concurrency, int page, int lastPage, int count, bool all, bool shard,
+             const BatchSearch::Configure& configure, std::ostream& out) {
+    std::ifstream batch_file;
+    if (batch != "-") {
+        batch_file.open(batch);
+        if (!batch_file) {
+            std::cerr << "Error: --batch: can't read " << batch << "\n";
+            return 1;
+        }
+    }
+    const std::vector<BatchQuery> queries = readBatch(batch == "-" ? std::cin : batch_file);
+
+    BatchOptions options;
+    options.concurrency = std::max(1, concurrency);
+    options.page = page;
+    if (shard) {
+        options.mode = BatchOptions::Mode::Shard;
+    } else if (all) {
+        options.mode = BatchOptions::Mode::All;
+    } else if (count > 0) {
+        options.mode = BatchOptions::Mode::Count;
+        options.count = static_cast<size_t>(count);
+    } else if (lastPage > page) {
+        options.mode = BatchOptions::Mode::Range;
+        options.last_page = lastPage;
+    }
+    std::cout << "Running " << queries.size() << " queries, " << options.concurrency << " at a time.\n";
+    BatchSearch batch_search(options, configure);
+    const BatchStats stats = batch_search.run(queries, out);
+    std::cout << "Batch: " << stats.queries << " queries, " << stats.failed << " failed, " << stats.results
+              << " results in " << std::fixed << std::setprecision(1) << stats.wall_ms << " ms.\n";
+    printTransferStats(batch_search.getSession());
+    return stats.failed ? 2 : 0;
+}
+
 int main(int argc, char* argv[]) {
     loadDotEnv();
 
     std::string searchTerm;
     std::vector<std::string> qualifiers;
     int page = 1;
+    int lastPage = 0;
+    int count = 0;
+    int perPage = -1;  // -1: library default, or adaptive with -c
+    int jobs = 4;
+    std::string fields;
+    std::string parser = "stream";
+    std::string where;
+    std::string sort;
+    bool all = false;
+    bool shard = false;
+    std::string seen;
+    std::string batch;
+    int concurrency = 4;
+    const char* env_api_url = std::getenv("GITHUB_API_URL");
+    std::string apiUrl = env_api_url ? env_api_url : "";
 
-    parseArgs(argc, argv, searchTerm, qualifiers, page);
+    parseArgs(argc, argv, searchTerm, qualifiers, page, lastPage, count, perPage, jobs, fields, parser, where, sort, all, shard, seen, batch,
+              concurrency, apiUrl);
 
-    if (searchTerm.empty()) {
-        std::cerr << "Usage: github-searcher -s \"search term\" [-q \"qualifier\"]... [-p page]\n";
+    if (searchTerm.empty() && batch.empty()) {
+        std::cerr << "Usage: github-searcher -s \"search term\" [-q \"qualifier\"]... [-p page] [-l last_page] [-c count] [--all] [--shard] [-n per_page|auto] [-j jobs] [--fields a,b.c,...] [--parser stream|simd|view] [--where filter] [--sort stars|pushed] [--seen file] [--batch file|- [--concurrency n]] [--api-url url]\n";
         std::cerr << "Example: github-searcher -s \"cpp web server\" -q \"stars:>500\" -q \"language:C++\"\n";
         return 1;
     }
 
+    TableFilter filter;
+    std::string filter_error;
+    if (!TableFilter::parse(where, filter, filter_error)) {
+        std::cerr << "Error: --where: " << filter_error << "\n";
+        return 1;
+    }
+    if (!sort.empty() && sort != "stars" && sort != "pushed") {
+        std::cerr << "Error: --sort takes stars or pushed\n";
+        return 1;
+    }
+    // ids printed by earlier runs with the same --seen file
+    RepoIdSet seen_ids;
+    std::string seen_error;
+    if (!seen.empty() && !seen_ids.load(seen, seen_error)) {
+        std::cerr << "Error: --seen: " << seen_error << "\n";
+        return 1;
+    }
+    const size_t seen_before = seen_ids.size();
+
+    // --where and --sort work on the parsed columns of a ProjectTable
+    const bool use_table = !filter.empty() || !sort.empty();
+
+    // with --batch, stdout carries nothing but the NDJSON results
+    std::streambuf* const stdout_buffer = std::cout.rdbuf();
+    std::ostream ndjson(stdout_buffer);
+    if (!batch.empty()) std::cout.rdbuf(std::cerr.rdbuf());
+
     printHeader("GitHub Repository Search CLI");
 
     CURLcode global_init_res = curl_global_init(CURL_GLOBAL_ALL);
     if (global_init_res != CURLE_OK) {
         std::cerr << "CRITICAL ERROR: Failed to initialize libcurl globally.\n";
         std::cerr << "libcurl error: " << curl_easy_strerror(global_init_res) << '\n';
+        std::cout.rdbuf(stdout_buffer);
         return 1;
     }
 
+    const std::vector<std::string> env_tokens = TokenPool::tokensFromEnvironment();
+    // one pool for every downloader, so they pace against the same rate-limit budget
+    const auto token_pool = std::make_shared<TokenPool>(env_tokens);
+    if (!env_tokens.empty()) {
+        std::cout << env_tokens.size() << " GitHub API token(s) loaded from environment.\n";
+    } else {
+        std::cout << "No GitHub API token found in environment. You may be rate-limited.\n";
+    }
+
+    SearchParser search_parser = SearchParser::Stream;
+    if (parser == "simd" || parser == "view") {
+        search_parser = SearchParser::Structural;
+    } else if (parser != "stream") {
+        std::cerr << "Warning: Unknown parser \"" << parser << "\", using stream.\n";
+    }
+    const SearchFields search_fields = fields.empty() ? SearchFields() : SearchFields::parse(fields);
+    for (const std::string& path : filter.fieldPaths()) {
+        if (!search_fields.contains(path)) {
+            std::cerr << "Warning: --where tests " << path << ", which --fields doesn't request; no repository has it.\n";
+        }
+    }
+
+    // the same setup for the downloader of a single query and each batch worker's
+    auto configure = [&](CurlDownloader& downloader) {
+        if (!apiUrl.empty()) downloader.set_api_base_url(apiUrl);
+        downloader.set_token_pool(token_pool);
+        if (perPage != -1) {
+            downloader.set_per_page(perPage);
+        } else if (count > 0 || all || shard) {
+            downloader.set_per_page(CurlDownloader::ADAPTIVE_PER_PAGE);
+        }
+        downloader.set_search_parser(search_parser);
+        downloader.set_search_fields(search_fields);
+        downloader.set_max_in_flight(jobs);
+    };
+
+    if (!batch.empty()) {
+        if (!apiUrl.empty()) std::cout << "Using API at " << apiUrl << "\n";
+        if (!where.empty() || !sort.empty() || !seen.empty()) {
+            std::cerr << "Warning: --where, --sort and --seen don't apply to --batch.\n";
+        }
+        const int status = runBatch(batch, concurrency, page, lastPage, count, all, shard, configure, ndjson);
+        curl_global_cleanup();
+        std::cout.rdbuf(stdout_buffer);
+        return status;
+    }
+
     CurlDownloader downloader;
+    configure(downloader);
+    if (!apiUrl.empty()) std::cout << "Using API at " << downloader.getApiBaseUrl() << "\n";
 
-    const char* env_token = std::getenv("GITHUB_TOKEN");
-    if (env_token && std::string(env_token).length() > 0) {
-        downloader.set_auth_token(std::string(env_token));
-        std::cout << "GitHub API token loaded from environment.\n";
+    // printed from views either way; with --parser view a single page is never copied out of the response
+    SearchPage found_projects;
+    std::vector<ProjectInfo> projects;
+    ProjectTable table(downloader.getSearchFields());  // with --where/--sort: filtered and ordered column by column
+    long http_status = 0;
+    CrawlStats crawl_stats;
+    ShardPlan shard_plan;
+    if (shard) {
+        // every result, past the 1000-result cap, by splitting the query into stars/created ranges
+        http_status = downloader.searchRepositoriesSharded(searchTerm, qualifiers, projects, &shard_plan);
+    } else if (all) {
+        // every result, fetching each page while the previous one is parsed
+        http_status = downloader.crawlRepositories(searchTerm, qualifiers, projects, &crawl_stats);
+    } else if (count > 0) {
+        // the first count results, in as few requests as the page size allows
+        http_status = downloader.searchRepositoriesCount(searchTerm, qualifiers, static_cast<size_t>(count), projects);
+    } else if (lastPage > page) {
+        // fetch the whole page range concurrently
+        http_status = downloader.searchRepositoriesRange(searchTerm, qualifiers, page, lastPage, projects);
+    } else if (use_table) {
+        http_status = downloader.searchRepositories(searchTerm, qualifiers, table, page);
+    } else if (parser == "view") {
+        http_status = downloader.searchRepositories(searchTerm, qualifiers, found_projects, page);
     } else {
-        std::cout << "No GitHub API token found in environment. You may be rate-limited.\n";
+        http_status = downloader.searchRepositories(searchTerm, qualifiers, projects, page);
+    }
+    if (use_table) {
+        table.append(projects);
+    } else if (!projects.empty()) {
+        found_projects.assign(std::move(projects), downloader.getSearchFields());
     }
 
-    std::vector<ProjectInfo> found_projects;
-    long http_status = downloader.searchRepositories(searchTerm, qualifiers, found_projects, page);
+    const SearchPageMeta& meta = downloader.lastPageMeta();
+    if (!all && !shard && meta.total_count >= 0) {
+        std::cout << "Total: " << meta.total_count << " result(s)"
+                  << (meta.incomplete_results ? " (incomplete, the search timed out)" : "") << ".\n";
+    }
+    if (all) {
+        std::cout << "Crawled " << (use_table ? table.size() : found_projects.size()) << " of ";
+        if (crawl_stats.total_count < 0) {
+            std::cout << "?";
+        } else {
+            std::cout << crawl_stats.total_count;
+        }
+        std::cout << " results in " << crawl_stats.pages << " page(s): " << std::fixed << std::setprecision(1)
+                  << crawl_stats.wall_ms << " ms wall, " << crawl_stats.fetch_ms << " ms fetching, "
+                  << crawl_stats.parse_ms << " ms parsing, " << crawl_stats.duplicates << " duplicate(s) dropped.\n";
+        if (crawl_stats.total_count > static_cast<long long>(CurlDownloader::MAX_SEARCH_RESULTS)) {
+            std::cerr << "Warning: GitHub only returns the first " << CurlDownloader::MAX_SEARCH_RESULTS
+                      << " results of a search; --shard fetches all of them.\n";
+        }
+    } else if (shard) {
+        std::cout << "Sharded " << shard_plan.total_count << " results into " << shard_plan.shards.size()
+                  << " shard(s) with " << shard_plan.probes << " probe(s) and " << shard_plan.page_requests
+                  << " page request(s); " << shard_plan.duplicates << " duplicate(s) dropped.\n";
+    }
 
     if (http_status == 200) {
-        if (found_projects.empty()) {
+        // row numbers of the results to print
+        std::vector<size_t> shown;
+        if (!filter.empty()) {
+            const auto filter_start = std::chrono::steady_clock::now();
+            const Selection selection = filter.select(table);
+            const double filter_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - filter_start).count();
+            selection.forEach([&shown](size_t row) { shown.push_back(row); });
+            std::cout << "Filter matched " << shown.size() << " of " << table.size() << " repositories in "
+                      << std::fixed << std::setprecision(3) << filter_ms << " ms.\n";
+        } else {
+            for (size_t i = 0; i < (use_table ? table.size() : found_projects.size()); ++i) shown.push_back(i);
+        }
+        if (use_table) {
+            const StringInterner::Stats interned = StringInterner::global().stats();
+            if (interned.lookups > 0) {
+                std::cout << "Interned " << interned.lookups << " field values as " << interned.strings << " strings, "
+                          << interned.savedBytes() << " bytes saved.\n";
+            }
+        }
+        if (!seen.empty()) {
+            // only what no earlier run printed, and remember it for the next one
+            size_t repeated = 0;
+            std::vector<size_t> unseen;
+            for (size_t row : shown) {
+                const int64_t id = use_table ? table.ids()[row] : found_projects[row].id;
+                if (seen_ids.insert(id)) {
+                    unseen.push_back(row);
+                } else {
+                    ++repeated;
+                }
+            }
+            shown.swap(unseen);
+            if (!seen_ids.save(seen, seen_error)) {
+                std::cerr << "Error: --seen: " << seen_error << "\n";
+            }
+            std::cout << "Skipped " << repeated << " repositories seen in earlier runs; " << seen << " now holds "
+                      << seen_ids.size() << " ids (" << (seen_ids.size() - seen_before) << " new).\n";
+        }
+        if (!sort.empty()) {
+            table.sortRows(shown, sort == "stars" ? ProjectTable::SortKey::Stars : ProjectTable::SortKey::Pushed);
+        }
+        if (shown.empty()) {
             std::cout << "No repositories found matching your criteria.\n";
         } else {
-            std::cout << "Found " << found_projects.size() << " repositories.\n";
+            std::cout << "Found " << shown.size() << " repositories.\n";
             printSeparator();
-            for (size_t i = 0; i < found_projects.size(); ++i) {
-                const auto& project = found_projects[i];
+            for (size_t i = 0; i < shown.size(); ++i) {
+                const ProjectInfoView project = use_table ? table.row(shown[i]) : found_projects[shown[i]];
                 std::cout << "Result " << (i + 1) << ":\n";
+                if (!downloader.getSearchFields().isDefault()) {
+                    // just what --fields asked for, in that order
+                    for (const auto& field : downloader.getSearchFields().values(project)) {
+                        std::cout << "  " << std::left << std::setw(20) << (field.first + ":") << " " << field.second << "\n";
+                    }
+                    printSeparator('.');
+                    continue;
+                }
                 std::cout << "  Name:        " << project.name << "\n";
                 std::cout << "  URL:         " << project.html_url << "\n";
                 std::cout << "  Description: " << (project.description.empty() ? "No description provided." : project.description) << "\n";
                 std::cout << "  Stars:       " << project.stargazers_count << "\n";
-                std::cout << "  Last Push:   " << project.pushed_at << "\n";
-                std::cout << "  License:     " << project.license << "\n";
+                std::cout << "  Last Push:   " << project.pushedAtText() << "\n";
+                std::cout << "  License:     " << project.licenseName() << "\n";
                 printSeparator('.');
             }
         }
     } else {
         std::cerr << "GitHub API request failed. HTTP status: " << http_status << "\n";
+        const RateLimitScheduler::Budget budget = downloader.getTokenPool().budget("search");
+        if ((http_status == 403 || http_status == 429) && budget.remaining == 0 && budget.reset > 0) {
+            std::cerr << "Search rate limit exhausted (" << budget.limit << " per window), resets at "
+                      << std::put_time(std::localtime(&budget.reset), "%H:%M:%S") << ".\n";
+        }
     }
 
+    printTransferStats(downloader.getSession());
+
     curl_global_cleanup();
     return 0;
 }
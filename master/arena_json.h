@@ -0,0 +1,45 @@
+#ifndef ARENA_JSON_H
+#define ARENA_JSON_H
+
+#include <cstdint>
+#include <map>
+#include <memory_resource>
+#include <string>
+#include <vector>
+#include "json.hpp"
+#include "page_arena.h"
+
+// Allocator for types that default-construct their allocators (json.hpp
+// does, for every node, array and string): it picks up the resource of the
+// innermost PageArena::Scope at construction and sticks with it.
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    ArenaAllocator() noexcept : resource(PageArena::current()) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : resource(other.memoryResource()) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(resource->allocate(n * sizeof(T), alignof(T))); }
+    void deallocate(T* p, size_t n) noexcept { resource->deallocate(p, n * sizeof(T), alignof(T)); }
+
+    std::pmr::memory_resource* memoryResource() const noexcept { return resource; }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept { return resource == other.memoryResource(); }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const noexcept { return resource != other.memoryResource(); }
+
+private:
+    std::pmr::memory_resource* resource;
+};
+
+using ArenaString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+// nlohmann::json with every node, member map, array and string in the arena
+// of the current PageArena::Scope. Parse and drop it inside the same scope.
+using ArenaJson = nlohmann::basic_json<std::map, std::vector, ArenaString, bool, std::int64_t,
+                                       std::uint64_t, double, ArenaAllocator>;
+
+#endif
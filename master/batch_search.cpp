@@ -0,0 +1,150 @@
+#include "batch_search.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include "curl_downloader.h"
+
+// key:value with a key of letters (and _), optionally negated with a leading '-'
+static bool isQualifier(const std::string& word) {
+  const size_t colon = word.find(':');
+  const size_t key_start = !word.empty() && word[0] == '-' ? 1 : 0;
+  if (colon == std::string::npos || colon == key_start || colon + 1 == word.size()) return false;
+  for (size_t i = key_start; i < colon; ++i) {
+      if (!std::isalpha(static_cast<unsigned char>(word[i])) && word[i] != '_') return false;
+  }
+  return true;
+}
+
+bool BatchQuery::parse(const std::string& line_text, size_t line_number, BatchQuery& out) {
+  const size_t first = line_text.find_first_not_of(" \t\r");
+  if (first == std::string::npos || line_text[first] == '#') return false;
+  out = BatchQuery();
+  out.line = line_number;
+  out.text = line_text.substr(first, line_text.find_last_not_of(" \t\r") + 1 - first);
+
+  // words, keeping "quoted phrases" (quotes included) together
+  std::vector<std::string> words;
+  std::string word;
+  bool quoted = false;
+  for (char c : out.text) {
+      if (c == '"') quoted = !quoted;
+      if (!quoted && (c == ' ' || c == '\t')) {
+          if (!word.empty()) words.push_back(std::move(word));
+          word.clear();
+          continue;
+      }
+      word += c;
+  }
+  if (!word.empty()) words.push_back(std::move(word));
+
+  for (const std::string& w : words) {
+      if (isQualifier(w)) {
+          out.qualifiers.push_back(w);
+      } else {
+          if (!out.search_term.empty()) out.search_term += ' ';
+          out.search_term += w;
+      }
+  }
+  return true;
+}
+
+std::vector<BatchQuery> readBatch(std::istream& in) {
+  std::vector<BatchQuery> queries;
+  std::string line;
+  for (size_t number = 1; std::getline(in, line); ++number) {
+      BatchQuery query;
+      if (BatchQuery::parse(line, number, query)) queries.push_back(std::move(query));
+  }
+  return queries;
+}
+
+BatchSearch::BatchSearch(BatchOptions options, Configure configure)
+    : options(options), configure(std::move(configure)), session(std::make_shared<CurlSession>(false)) {}
+
+static long runQuery(CurlDownloader& downloader, const BatchOptions& options, const BatchQuery& query,
+                     std::vector<ProjectInfo>& projects) {
+  switch (options.mode) {
+      case BatchOptions::Mode::Shard:
+          return downloader.searchRepositoriesSharded(query.search_term, query.qualifiers, projects);
+      case BatchOptions::Mode::All:
+          return downloader.crawlRepositories(query.search_term, query.qualifiers, projects);
+      case BatchOptions::Mode::Count:
+          return downloader.searchRepositoriesCount(query.search_term, query.qualifiers, options.count, projects);
+      case BatchOptions::Mode::Range:
+          return downloader.searchRepositoriesRange(query.search_term, query.qualifiers, options.page, options.last_page,
+                                                    projects);
+      case BatchOptions::Mode::Page:
+          break;
+  }
+  return downloader.searchRepositories(query.search_term, query.qualifiers, projects, options.page);
+}
+
+// the requested fields under their paths; numbers stay numbers and a missing
+// push is null, everything else is the text the CLI would print
+static nlohmann::json resultRecord(const BatchQuery& query, size_t rank, const ProjectInfo& project,
+                                   const SearchFields& fields) {
+  nlohmann::json record = {{"line", query.line}, {"query", query.text}, {"rank", rank}};
+  for (const auto& field : fields.values(project)) record[field.first] = field.second;
+  record["id"] = project.id;  // always there, requested or not
+  if (fields.contains("stargazers_count")) record["stargazers_count"] = project.stargazers_count;
+  if (fields.contains("pushed_at") && project.pushed_at == NO_TIMESTAMP) record["pushed_at"] = nullptr;
+  return record;
+}
+
+BatchStats BatchSearch::run(const std::vector<BatchQuery>& queries, std::ostream& out) {
+  const auto start = std::chrono::steady_clock::now();
+  BatchStats stats;
+  stats.queries = queries.size();
+  std::atomic<size_t> next{0};
+  std::mutex out_mutex;  // guards out and stats
+
+  auto worker = [&]() {
+      CurlDownloader downloader(session);
+      if (configure) configure(downloader);
+      for (size_t index = next++; index < queries.size(); index = next++) {
+          const BatchQuery& query = queries[index];
+          std::vector<ProjectInfo> projects;
+          const long status = runQuery(downloader, options, query, projects);
+
+          // the lines are built before taking the lock, which only covers the write
+          std::string lines;
+          if (status == 200 && projects.empty()) {
+              // so every query shows up in the output, even one that found nothing
+              const nlohmann::json record = {{"line", query.line}, {"query", query.text}, {"status", status},
+                                             {"results", 0}};
+              lines = record.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace) + "\n";
+          } else if (status == 200) {
+              for (size_t i = 0; i < projects.size(); ++i) {
+                  lines += resultRecord(query, i + 1, projects[i], downloader.getSearchFields())
+                               .dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+                  lines += '\n';
+              }
+          } else {
+              const nlohmann::json record = {{"line", query.line}, {"query", query.text}, {"status", status},
+                                             {"error", status < 0 ? "transfer failed" : "request failed"}};
+              lines = record.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace) + "\n";
+          }
+          std::lock_guard<std::mutex> lock(out_mutex);
+          out << lines << std::flush;
+          if (status == 200) {
+              stats.results += projects.size();
+          } else {
+              ++stats.failed;
+          }
+      }
+  };
+
+  const size_t workers = std::min(queries.size(), static_cast<size_t>(std::max(1, options.concurrency)));
+  std::vector<std::thread> threads;
+  threads.reserve(workers);
+  for (size_t i = 0; i < workers; ++i) threads.emplace_back(worker);
+  for (std::thread& thread : threads) thread.join();
+
+  stats.wall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  return stats;
+}
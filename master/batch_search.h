@@ -0,0 +1,74 @@
+#ifndef BATCH_SEARCH_H
+#define BATCH_SEARCH_H
+
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+#include "curl_session.h"
+
+class CurlDownloader;
+
+// One line of a batch file: a search term and its qualifiers, written the way
+// the github.com search box takes them ("web server language:C++ stars:>500").
+// Words shaped like key:value (or -key:value) are qualifiers, the rest make up
+// the term; a double-quoted phrase stays one word.
+struct BatchQuery {
+    size_t line = 0;   // 1-based, in the batch input
+    std::string text;  // the line as written, trimmed
+    std::string search_term;
+    std::vector<std::string> qualifiers;
+
+    // False for blank lines and # comments.
+    static bool parse(const std::string& line_text, size_t line_number, BatchQuery& out);
+};
+
+// Every query of a batch input, in line order.
+std::vector<BatchQuery> readBatch(std::istream& in);
+
+// What each query of a batch fetches, as the single-query CLI flags would.
+struct BatchOptions {
+    enum class Mode { Page, Range, Count, All, Shard };
+    Mode mode = Mode::Page;
+    int page = 1;
+    int last_page = 0;  // Range
+    size_t count = 0;   // Count
+    int concurrency = 4;  // queries in flight
+};
+
+struct BatchStats {
+    size_t queries = 0;
+    size_t failed = 0;   // queries whose last request didn't end in 200
+    size_t results = 0;  // NDJSON result lines written
+    double wall_ms = 0;
+};
+
+// Runs the queries of a batch on up to concurrency worker threads. Each
+// worker has a CurlDownloader of its own (easy handles aren't shared) for the
+// whole batch, set up by configure, which is where the workers get the same
+// token pool, fields and parser. The workers' downloaders share one
+// CurlSession for DNS and TLS session resumption; each keeps its connection
+// alive from one query to the next. A query's results are written to out as
+// soon as it finishes, one JSON object per line tagged with its line and
+// query text, in a single locked write so queries never interleave. A failed
+// query gets one line with its status instead, and so does one that found
+// nothing ({"status":200,"results":0}).
+class BatchSearch {
+public:
+    using Configure = std::function<void(CurlDownloader&)>;
+
+    BatchSearch(BatchOptions options, Configure configure);
+
+    BatchStats run(const std::vector<BatchQuery>& queries, std::ostream& out);
+
+    const CurlSession& getSession() const { return *session; }
+
+private:
+    BatchOptions options;
+    Configure configure;
+    std::shared_ptr<CurlSession> session;
+};
+
+#endif
@@ -0,0 +1,311 @@
+// Compares the two ways a search page is turned into ProjectInfo:
+//   dom     - json.hpp parses the whole page into a DOM, then items are read
+//             from it (what parseSearchResponse does)
+//   stream  - SearchStreamParser fed 16 KiB chunks, tokenizing only the path to
+//             the requested fields and skipping everything else
+//   simd    - StructuralSearchParser walking a SIMD structural index of the page
+//   view    - the same walk producing ProjectInfoViews into the page (SearchPage),
+//             decoding strings in place instead of copying them out
+//   *-arena - dom/simd with the DOM, strings and result vector in a PageArena
+//             that is reset after every page
+//   index-* - building the structural index alone, per instruction set
+//
+// allocs/page counts calls to the global operator new.
+//
+// Before timing, the stream, simd and view results are checked against json.hpp,
+// and SearchPageMeta against a few Link headers.
+//
+//   parse-bench PAGE.json... [-i iterations] [--fields a,b.c,...]
+//
+// Record 100-item pages from the mock server (or GitHub) first, e.g.
+// `curl 'http://127.0.0.1:8089/search/repositories?q=x&per_page=100&page=1' > page-1.json`.
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "arena_json.h"
+#include "json.hpp"
+#include "page_arena.h"
+#include "search_stream_parser.h"
+#include "search_page.h"
+#include "search_page_meta.h"
+#include "structural_search_parser.h"
+
+static std::atomic<unsigned long long> heap_allocations{0};
+
+#if defined(__GNUC__) && !defined(__clang__)
+// GCC sees free() paired with operator new once these are inlined
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void* operator new(std::size_t size) {
+    ++heap_allocations;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+static size_t domParse(const std::string& body, std::vector<ProjectInfo>& out) {
+    nlohmann::json json_response = nlohmann::json::parse(body);
+    for (const auto& item : json_response["items"]) {
+        ProjectInfo project;
+        project.setName(item.value("full_name", "N/A"));
+        project.html_url = item.value("html_url", "N/A");
+        if (item.contains("description") && !item["description"].is_null()) {
+            project.description = item["description"].get<std::string>();
+        } else {
+            project.description = "N/A";
+        }
+        if (!parseIsoTimestamp(item.value("pushed_at", ""), project.pushed_at)) project.pushed_at = NO_TIMESTAMP;
+        if (item.contains("id") && item["id"].is_number_integer()) project.id = item["id"].get<std::int64_t>();
+        project.stargazers_count = item.value("stargazers_count", 0);
+        if (item.contains("license") && item["license"].is_object() && item["license"].contains("spdx_id")) {
+            project.license = spdxLicense(item["license"]["spdx_id"].get<std::string>());
+        }
+        out.push_back(project);
+    }
+    return out.size();
+}
+
+static size_t streamParse(const std::string& body, const SearchFields& fields, std::vector<ProjectInfo>& out) {
+    const size_t chunk = 16 * 1024;  // typical libcurl write callback size
+    SearchStreamParser parser(fields, [&out](ProjectInfo&& project) { out.push_back(std::move(project)); });
+    for (size_t offset = 0; offset < body.size(); offset += chunk) {
+        parser.feed(body.data() + offset, std::min(chunk, body.size() - offset));
+    }
+    if (!parser.finish()) std::cerr << "Error: stream parse failed: " << parser.error() << "\n";
+    return parser.itemCount();
+}
+
+static size_t structuralParse(const std::string& body, StructuralSearchParser& parser, std::vector<ProjectInfo>& out) {
+    if (!parser.parse(body, out)) std::cerr << "Error: structural parse failed: " << parser.error() << "\n";
+    return out.size();
+}
+
+static size_t domArenaParse(const std::string& body, const SearchFields& fields, PageArena& arena) {
+    size_t items = 0;
+    {
+        std::pmr::vector<ProjectInfo> out(arena.resource());
+        PageArena::Scope scope(arena.resource());
+        ArenaJson json_response = ArenaJson::parse(body);
+        for (const auto& item : json_response["items"]) out.push_back(fields.extract(item, out.get_allocator()));
+        items = out.size();
+    }
+    arena.reset();
+    return items;
+}
+
+static size_t structuralArenaParse(const std::string& body, StructuralSearchParser& parser, PageArena& arena) {
+    size_t items = 0;
+    {
+        std::pmr::vector<ProjectInfo> out(arena.resource());
+        if (!parser.parse(body, out)) std::cerr << "Error: structural parse failed: " << parser.error() << "\n";
+        items = out.size();
+    }
+    arena.reset();
+    return items;
+}
+
+// the body is copied into a buffer kept across pages, as the response buffer would be
+static size_t viewParse(const std::string& body, std::shared_ptr<std::string>& buffer,
+                        StructuralSearchParser& parser, SearchPage& page) {
+    buffer->assign(body);
+    if (!page.parse(buffer, parser)) std::cerr << "Error: view parse failed: " << parser.error() << "\n";
+    const size_t items = page.size();
+    page.clear();
+    return items;
+}
+
+static bool sameProject(const ProjectInfo& a, const ProjectInfo& b) {
+    return a.name == b.name && a.owner_length == b.owner_length && a.html_url == b.html_url && a.description == b.description &&
+           a.id == b.id && a.pushed_at == b.pushed_at && a.stargazers_count == b.stargazers_count && a.license == b.license &&
+           a.extra_fields == b.extra_fields;
+}
+
+// json.hpp is the oracle: every fast path has to produce exactly what it does
+static bool verify(const std::vector<std::string>& pages, const SearchFields& fields) {
+    bool ok = true;
+    for (size_t p = 0; p < pages.size(); ++p) {
+        std::vector<ProjectInfo> expected, streamed, structural, viewed, arena_dom, arena_structural;
+        const nlohmann::json page = nlohmann::json::parse(pages[p]);
+        for (const auto& item : page["items"]) expected.push_back(fields.extract(item));
+        streamParse(pages[p], fields, streamed);
+        StructuralSearchParser parser(fields);
+        structuralParse(pages[p], parser, structural);
+        SearchPage view_page;
+        if (fields.hasNestedRequests()) viewed = expected;  // not viewable, see SearchFields
+        else if (view_page.parse(std::make_shared<std::string>(pages[p]), parser)) view_page.appendTo(viewed);
+        PageArena arena;
+        {
+            std::pmr::vector<ProjectInfo> out(arena.resource());
+            PageArena::Scope scope(arena.resource());
+            ArenaJson dom = ArenaJson::parse(pages[p]);
+            for (const auto& item : dom["items"]) out.push_back(fields.extract(item, out.get_allocator()));
+            arena_dom.assign(out.begin(), out.end());  // copies leave the arena
+        }
+        arena.reset();
+        {
+            std::pmr::vector<ProjectInfo> out(arena.resource());
+            if (parser.parse(pages[p], out)) arena_structural.assign(out.begin(), out.end());
+        }
+        arena.reset();
+        const std::pair<const char*, const std::vector<ProjectInfo>*> results[] = {
+            {"stream", &streamed}, {"simd", &structural}, {"view", &viewed},
+            {"dom-arena", &arena_dom}, {"simd-arena", &arena_structural}};
+        for (const auto& named : results) {
+            const std::vector<ProjectInfo>* result = named.second;
+            bool same = result->size() == expected.size();
+            for (size_t i = 0; same && i < expected.size(); ++i) same = sameProject((*result)[i], expected[i]);
+            if (!same) {
+                std::cerr << "Warning: page " << (p + 1) << ": " << named.first << " result differs from json.hpp" << "\n";
+                ok = false;
+            }
+        }
+    }
+    return ok;
+}
+
+// Link headers as GitHub sends them (percent-encoded) and with a raw ' ', '>'
+// and ',' left in the targets, which must not end a target early
+static bool verifyLinkHeaders() {
+    struct Case {
+        const char* link;
+        int next, prev, last;
+    };
+    const Case cases[] = {
+        {"<https://api.github.com/search/repositories?q=web+stars%3A%3E10&per_page=5&page=2>; rel=\"prev\", "
+         "<https://api.github.com/search/repositories?q=web+stars%3A%3E10&per_page=5&page=4>; rel=\"next\", "
+         "<https://api.github.com/search/repositories?q=web+stars%3A%3E10&per_page=5&page=34>; rel=\"last\", "
+         "<https://api.github.com/search/repositories?q=web+stars%3A%3E10&per_page=5&page=1>; rel=\"first\"",
+         4, 2, 34},
+        {"<http://127.0.0.1:8089/search/repositories?per_page=5&q=web stars:>10&page=2>; rel=\"next\", "
+         "<http://127.0.0.1:8089/search/repositories?per_page=5&q=web stars:>10&page=200>; rel=\"last\"",
+         2, 0, 200},
+        {"<http://localhost/search/repositories?q=a,b language:c>d&page=6>;rel=\"prev\",<http://localhost/"
+         "search/repositories?q=a,b language:c>d&page=7>; rel=\"last\"",
+         0, 6, 7},
+    };
+    bool ok = true;
+    for (const Case& c : cases) {
+        const SearchPageMeta meta = SearchPageMeta::parse("{}", HttpHeaders{{"link", c.link}});
+        if (meta.next_page != c.next || meta.prev_page != c.prev || meta.last_page != c.last) {
+            std::cerr << "Warning: Link header parsed as next=" << meta.next_page << " prev=" << meta.prev_page
+                      << " last=" << meta.last_page << ": " << c.link << "\n";
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+template <typename Parse>
+static void run(const std::string& name, const std::vector<std::string>& pages, int iterations, Parse parse) {
+    size_t bytes = 0, items = 0;
+    std::vector<ProjectInfo> out;
+    const unsigned long long allocations = heap_allocations;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        for (const std::string& page : pages) {
+            out.clear();
+            items += parse(page, out);
+            bytes += page.size();
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const double runs = static_cast<double>(iterations) * static_cast<double>(pages.size());
+    std::cout << std::left << std::setw(14) << name << std::right << std::fixed << std::setprecision(3)
+              << std::setw(8) << (bytes / seconds / 1e9) << " GB/s" << std::setprecision(1)
+              << std::setw(12) << (seconds * 1e6 / runs) << " us/page"
+              << std::setw(12) << std::setprecision(0) << (items / seconds) << " items/s"
+              << std::setw(10) << std::setprecision(1) << ((heap_allocations - allocations) / runs) << " allocs/page" << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> pages;
+    int iterations = 200;
+    std::string field_list;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-i" && i + 1 < argc) {
+            iterations = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--fields" && i + 1 < argc) {
+            field_list = argv[++i];
+        } else {
+            std::ifstream file(arg, std::ios::binary);
+            if (!file) {
+                std::cerr << "Error: Cannot read " << arg << "\n";
+                return 1;
+            }
+            std::ostringstream contents;
+            contents << file.rdbuf();
+            pages.push_back(contents.str());
+        }
+    }
+    if (pages.empty()) {
+        std::cerr << "Usage: parse-bench PAGE.json... [-i iterations] [--fields a,b.c,...]\n";
+        return 1;
+    }
+
+    size_t total = 0;
+    for (const std::string& page : pages) total += page.size();
+    std::cout << pages.size() << " page(s), " << total << " bytes, " << iterations << " iterations" << "\n";
+
+    const SearchFields defaults;
+    bool verified = verify(pages, defaults);
+    verified = verifyLinkHeaders() && verified;
+    run("dom", pages, iterations, domParse);
+    run("stream", pages, iterations, [&](const std::string& page, std::vector<ProjectInfo>& out) {
+        return streamParse(page, defaults, out);
+    });
+    StructuralSearchParser structural(defaults);
+    run("simd", pages, iterations, [&](const std::string& page, std::vector<ProjectInfo>& out) {
+        return structuralParse(page, structural, out);
+    });
+    PageArena arena;
+    run("dom-arena", pages, iterations, [&](const std::string& page, std::vector<ProjectInfo>&) {
+        return domArenaParse(page, defaults, arena);
+    });
+    run("simd-arena", pages, iterations, [&](const std::string& page, std::vector<ProjectInfo>&) {
+        return structuralArenaParse(page, structural, arena);
+    });
+    auto buffer = std::make_shared<std::string>();
+    SearchPage page;
+    run("view", pages, iterations, [&](const std::string& body, std::vector<ProjectInfo>&) {
+        return viewParse(body, buffer, structural, page);
+    });
+    if (!field_list.empty()) {
+        const SearchFields custom = SearchFields::parse(field_list);
+        verified = verify(pages, custom) && verified;
+        run("stream-fields", pages, iterations, [&](const std::string& page, std::vector<ProjectInfo>& out) {
+            return streamParse(page, custom, out);
+        });
+        StructuralSearchParser structural_custom(custom);
+        run("simd-fields", pages, iterations, [&](const std::string& page, std::vector<ProjectInfo>& out) {
+            return structuralParse(page, structural_custom, out);
+        });
+        if (!custom.hasNestedRequests()) {
+            run("view-fields", pages, iterations, [&](const std::string& body, std::vector<ProjectInfo>&) {
+                return viewParse(body, buffer, structural_custom, page);
+            });
+        }
+    }
+    const PageArena::Stats arena_stats = arena.stats();
+    std::cout << "arena: " << arena_stats.pages << " pages, " << arena_stats.upstream_allocations
+              << " upstream allocations, " << arena_stats.block_size << " byte block" << "\n";
+
+    for (StructuralIndex::Isa isa : {StructuralIndex::Isa::Scalar, StructuralIndex::Isa::Sse2, StructuralIndex::Isa::Avx2}) {
+        if (!StructuralIndex::supported(isa)) continue;
+        StructuralIndex index;
+        run(std::string("index-") + StructuralIndex::name(isa), pages, iterations,
+            [&](const std::string& page, std::vector<ProjectInfo>&) {
+                index.build(page.data(), page.size(), isa);
+                return size_t(0);
+            });
+    }
+    return verified ? 0 : 1;
+}
@@ -0,0 +1,93 @@
+// Turns N random "YYYY-MM-DDTHH:MM:SSZ" timestamps into epoch seconds with
+//   strptime  - POSIX strptime, then timegm
+//   get_time  - std::get_time on a reused istringstream, then timegm
+//   iso-time  - parseIsoTimestamp (iso_time.h), the SWAR fixed-format path
+//   iso-slow  - parseIsoTimestamp on the same instants written with +00:00,
+//               which takes its general path
+// and checks that they agree; the exit code is 1 when they don't.
+//
+//   time-bench [-n count] [-i iterations]
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "iso_time.h"
+
+template <typename Parse>
+static bool run(const char* name, const std::vector<std::string>& stamps, int iterations,
+                const std::vector<std::int64_t>& expected, Parse parse) {
+    std::vector<std::int64_t> out(stamps.size());
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        for (size_t s = 0; s < stamps.size(); ++s) out[s] = parse(stamps[s]);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const double count = static_cast<double>(stamps.size()) * iterations;
+    std::cout << std::left << std::setw(10) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << (seconds * 1e9 / count) << " ns/timestamp" << std::setprecision(2)
+              << std::setw(10) << (count / seconds / 1e6) << " M/s" << "\n";
+    if (out != expected) {
+        std::cerr << "Warning: " << name << " disagrees with parseIsoTimestamp" << "\n";
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    size_t count = 100000;
+    int iterations = 20;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-n" && i + 1 < argc) {
+            count = std::stoul(argv[++i]);
+        } else if (arg == "-i" && i + 1 < argc) {
+            iterations = std::max(1, std::stoi(argv[++i]));
+        } else {
+            std::cerr << "Usage: time-bench [-n count] [-i iterations]\n";
+            return 1;
+        }
+    }
+
+    // pushes spread over 2008 (GitHub's launch) to 2030
+    std::mt19937_64 random(7);
+    std::uniform_int_distribution<std::int64_t> instant(1199145600, 1893456000);
+    std::vector<std::string> stamps, offset_stamps;
+    std::vector<std::int64_t> expected;
+    for (size_t i = 0; i < count; ++i) {
+        expected.push_back(instant(random));
+        stamps.push_back(formatIsoTimestamp(expected.back()));
+        offset_stamps.push_back(stamps.back().substr(0, 19) + "+00:00");
+    }
+    std::cout << count << " timestamps, " << iterations << " iterations" << "\n";
+
+    bool ok = true;
+    ok = run("strptime", stamps, iterations, expected, [](const std::string& stamp) {
+        std::tm parts{};
+        strptime(stamp.c_str(), "%Y-%m-%dT%H:%M:%SZ", &parts);
+        return static_cast<std::int64_t>(timegm(&parts));
+    }) && ok;
+    std::istringstream stream;
+    ok = run("get_time", stamps, iterations, expected, [&stream](const std::string& stamp) {
+        std::tm parts{};
+        stream.clear();
+        stream.str(stamp);
+        stream >> std::get_time(&parts, "%Y-%m-%dT%H:%M:%S");
+        return static_cast<std::int64_t>(timegm(&parts));
+    }) && ok;
+    ok = run("iso-time", stamps, iterations, expected, [](const std::string& stamp) {
+        std::int64_t seconds = NO_TIMESTAMP;
+        parseIsoTimestamp(stamp, seconds);
+        return seconds;
+    }) && ok;
+    ok = run("iso-slow", offset_stamps, iterations, expected, [](const std::string& stamp) {
+        std::int64_t seconds = NO_TIMESTAMP;
+        parseIsoTimestamp(stamp, seconds);
+        return seconds;
+    }) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,131 @@
+// Compares the request throughput and TLS/TCP handshake count of the three
+// ways the downloader can fan out requests:
+//   single  - curl_easy_perform in a loop on one reused easy handle (the original design)
+//   http1   - N requests in flight over a pool of HTTP/1.1 keep-alive connections
+//   http2   - N requests in flight multiplexed as streams on one HTTP/2 connection
+//
+// Point it at a local HTTPS stand-in server that negotiates h2 via ALPN, e.g.
+// `nghttpd -d fixtures/ 8443 key.pem cert.pem`, passing its certificate with --cacert.
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "curl_downloader.h"
+
+struct BenchResult {
+    double seconds;
+    size_t failures;
+    CurlSession::Stats stats;
+};
+
+static BenchResult runMode(const std::string& url, int requests, int concurrency, TransportOptions options,
+                           const std::string& ca_file) {
+    options.ca_file = ca_file;
+    // fresh session per mode so handshake counts are not polluted by earlier runs
+    auto session = std::make_shared<CurlSession>();
+    CurlDownloader downloader(session);
+    downloader.set_transport_options(options);
+    downloader.set_max_in_flight(concurrency);
+
+    std::vector<HttpFetch> fetches(static_cast<size_t>(requests));
+    for (HttpFetch& fetch : fetches) fetch.url = url;
+
+    auto start = std::chrono::steady_clock::now();
+    downloader.fetchConcurrent(fetches);
+    auto end = std::chrono::steady_clock::now();
+
+    BenchResult result{std::chrono::duration<double>(end - start).count(), 0, session->stats()};
+    for (const HttpFetch& fetch : fetches) {
+        if (fetch.result != CURLE_OK || fetch.http_code != 200) ++result.failures;
+    }
+    return result;
+}
+
+static size_t discardBody(char*, size_t size, size_t nmemb, void* userdata) {
+    *static_cast<size_t*>(userdata) += size * nmemb;
+    return size * nmemb;
+}
+
+// the original design: blocking requests one after another on a single easy
+// handle, which keeps its HTTP/1.1 connection alive between them
+static BenchResult runSingle(const std::string& url, int requests, const std::string& ca_file) {
+    auto session = std::make_shared<CurlSession>();
+    CURL* handle = curl_easy_init();
+    session->attach(handle);
+    size_t body_bytes = 0;
+    curl_easy_setopt(handle, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_1_1);
+    curl_easy_setopt(handle, CURLOPT_ACCEPT_ENCODING, "");
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, discardBody);
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, &body_bytes);
+    if (!ca_file.empty()) curl_easy_setopt(handle, CURLOPT_CAINFO, ca_file.c_str());
+
+    BenchResult result{0, 0, {}};
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < requests; ++i) {
+        body_bytes = 0;
+        const CURLcode code = curl_easy_perform(handle);
+        long http_code = 0;
+        curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &http_code);
+        session->recordTransfer(handle, code, body_bytes);
+        if (code != CURLE_OK || http_code != 200) ++result.failures;
+    }
+    auto end = std::chrono::steady_clock::now();
+    curl_easy_cleanup(handle);
+
+    result.seconds = std::chrono::duration<double>(end - start).count();
+    result.stats = session->stats();
+    return result;
+}
+
+static void printResult(const std::string& mode, int requests, const BenchResult& result) {
+    std::cout << std::left << std::setw(8) << mode
+              << std::right << std::setw(10) << std::fixed << std::setprecision(1) << (requests / result.seconds) << " req/s"
+              << std::setw(8) << result.stats.new_connections << " handshakes"
+              << std::setw(8) << result.failures << " failed" << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::string url;
+    int requests = 200;
+    int concurrency = 20;
+    std::string ca_file;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-n" && i + 1 < argc) {
+            requests = std::stoi(argv[++i]);
+        } else if (arg == "-c" && i + 1 < argc) {
+            concurrency = std::stoi(argv[++i]);
+        } else if (arg == "--cacert" && i + 1 < argc) {
+            ca_file = argv[++i];
+        } else if (arg == "-h" || arg == "--help") {
+            url.clear();
+            break;
+        } else {
+            url = arg;
+        }
+    }
+    if (url.empty()) {
+        std::cerr << "Usage: transport-bench URL [-n requests] [-c concurrency] [--cacert file]\n";
+        return 1;
+    }
+
+    curl_global_init(CURL_GLOBAL_ALL);
+    std::cout << requests << " requests, " << concurrency << " in flight, against " << url << "\n";
+
+    printResult("single", requests, runSingle(url, requests, ca_file));
+
+    TransportOptions http1;
+    http1.http2 = false;
+    http1.max_host_connections = concurrency;
+    printResult("http1", requests, runMode(url, requests, concurrency, http1, ca_file));
+
+    TransportOptions http2;
+    http2.max_concurrent_streams = concurrency;
+    printResult("http2", requests, runMode(url, requests, concurrency, http2, ca_file));
+
+    curl_global_cleanup();
+    return 0;
+}
@@ -6,18 +6,90 @@
 #include <fstream>
 #include <atomic>
 #include <chrono>
+#include <deque>
+#include <ctime>
+#include <future>
+#include <string_view>
 #include <thread>
 
-CurlDownloader::CurlDownloader() {
+CurlDownloader::CurlDownloader(std::shared_ptr<CurlSession> session)
+    : session(std::move(session)), search_cache(SearchCache::global()),
+      buffer_pool(ResponseBufferPool::global()), tokens(std::make_shared<TokenPool>()) {
   curl_handle = curl_easy_init();
   if (!curl_handle) { std::cerr << "Error: curl_easy_init() failed. CurlDownloader will not work." << "\n"; }
+  applyDefaultOptions();
+  rebuildHeaders();
   git_libgit2_init();
 }
 
 CurlDownloader::~CurlDownloader() {
   if (curl_handle) { curl_easy_cleanup(curl_handle); }
+  for (struct curl_slist* headers : token_headers) { curl_slist_free_all(headers); }
   git_libgit2_shutdown();
 }
+
+// options that never change between requests are set once per handle,
+// the share attaches it to the process-wide connection/DNS/TLS caches
+void CurlDownloader::applyDefaultOptions() {
+  if (!curl_handle) return;
+  session->attach(curl_handle);
+  curl_easy_setopt(curl_handle, CURLOPT_USERAGENT, "MyGitHubClient/1.0");
+  curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, CurlDownloader::write_callback_std_string);
+  curl_easy_setopt(curl_handle, CURLOPT_HEADERFUNCTION, CurlDownloader::header_callback);
+  curl_easy_setopt(curl_handle, CURLOPT_FOLLOWLOCATION, 1L);
+  curl_easy_setopt(curl_handle, CURLOPT_TIMEOUT, 30L);
+  curl_easy_setopt(curl_handle, CURLOPT_TCP_KEEPALIVE, 1L);
+  // "" offers every encoding this libcurl was built with (gzip, deflate, br, zstd);
+  // libcurl inflates on the fly so the write callback only ever sees plain JSON
+  curl_easy_setopt(curl_handle, CURLOPT_ACCEPT_ENCODING, "");
+  curl_easy_setopt(curl_handle, CURLOPT_HTTP_VERSION,
+                   transport.http2 ? CURL_HTTP_VERSION_2TLS : CURL_HTTP_VERSION_1_1);
+  if (!transport.ca_file.empty()) {
+      curl_easy_setopt(curl_handle, CURLOPT_CAINFO, transport.ca_file.c_str());
+  }
+  // concurrent requests wait for the first connection to finish ALPN instead of
+  // each opening their own, so they can all multiplex onto it
+  curl_easy_setopt(curl_handle, CURLOPT_PIPEWAIT, transport.http2 ? 1L : 0L);
+}
+
+// byte accounting for a finished request, per request and session-wide
+TransferBytes CurlDownloader::finishTransfer(CURL* handle, CURLcode result, size_t decoded_bytes) {
+  session->recordTransfer(handle, result, decoded_bytes);
+  TransferBytes bytes;
+  curl_easy_getinfo(handle, CURLINFO_SIZE_DOWNLOAD_T, &bytes.wire);
+  bytes.decoded = static_cast<curl_off_t>(decoded_bytes);
+  return bytes;
+}
+
+// header lists only depend on the token, so one is kept per pool token and
+// they are rebuilt when the tokens change
+void CurlDownloader::rebuildHeaders() {
+  for (struct curl_slist* headers : token_headers) {
+      curl_slist_free_all(headers);
+  }
+  token_headers.assign(tokens->size(), nullptr);
+  for (size_t i = 0; i < tokens->size(); ++i) {
+      struct curl_slist* headers = nullptr;
+      if(!tokens->token(i).empty()) {
+        std::string auth_header = "Authorization: Bearer " + tokens->token(i);
+        headers = curl_slist_append(headers, auth_header.c_str());
+      }
+      token_headers[i] = curl_slist_append(headers, "Accept: application/vnd.github.v3+json");
+  }
+  if (curl_handle) {
+      curl_easy_setopt(curl_handle, CURLOPT_HTTPHEADER, token_headers[0]);
+  }
+}
+
+// copy of a token's header list plus If-None-Match, caller frees it
+struct curl_slist* CurlDownloader::buildConditionalHeaders(size_t token_index, const std::string& etag) const {
+  struct curl_slist* headers = nullptr;
+  for (const struct curl_slist* h = token_headers[token_index]; h; h = h->next) {
+      headers = curl_slist_append(headers, h->data);
+  }
+  std::string condition = "If-None-Match: " + etag;
+  return curl_slist_append(headers, condition.c_str());
+}
 // standard doc function (deprecated currently)
 // size_t CurlDownloader::WriteCallback(void* contents, size_t size, size_t nmemb, void* userp) {
 //  return fwrite(contents, size, nmemb, (FILE*)userp);
@@ -36,12 +108,60 @@ size_t CurlDownloader::write_callback_std_string(void* contents, size_t size, si
   }
   return new_length;
 }
+
+// keeps the raw body (error messages, retry decisions) and pushes it into the
+// fetch's stream parser as it arrives; headers are complete by the first
+// chunk, so that is when the body gets sized from Content-Length
+size_t CurlDownloader::write_callback_fetch(void* contents, size_t size, size_t nmemb, void* userdata) {
+  HttpFetch* fetch = static_cast<HttpFetch*>(userdata);
+  size_t length = size * nmemb;
+  if (!fetch->buffer_pool) {
+      length = write_callback_std_string(contents, size, nmemb, &fetch->body);
+  } else {
+      try {
+          if (fetch->body.empty()) fetch->buffer_pool->presize(fetch->body, fetch->headers);
+          fetch->buffer_pool->append(fetch->body, static_cast<const char*>(contents), length);
+      } catch (const std::bad_alloc& e) {
+          std::cerr << "Error: Failed to allocate memory in write_callback_fetch: " << e.what() << "\n";
+          return 0;
+      }
+  }
+  if (length && fetch->search_stream) {
+      fetch->search_stream->feed(static_cast<const char*>(contents), length);
+  }
+  return length;
+}
+
+// collects "Name: value" response headers with lowercased names; a new status
+// line (redirect, 100-continue) starts the set over
+size_t CurlDownloader::header_callback(char* buffer, size_t size, size_t nitems, void* userdata) {
+  size_t length = size * nitems;
+  if (!userdata) return length;
+  HttpHeaders* headers = static_cast<HttpHeaders*>(userdata);
+  std::string line(buffer, length);
+  if (line.compare(0, 5, "HTTP/") == 0) {
+      headers->clear();
+      return length;
+  }
+  size_t colon = line.find(':');
+  if (colon == std::string::npos) return length;
+  std::string name = line.substr(0, colon);
+  std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+  size_t value_start = line.find_first_not_of(" \t", colon + 1);
+  size_t value_end = line.find_last_not_of(" \t\r\n");
+  (*headers)[name] = (value_start == std::string::npos || value_end < value_start)
+                         ? ""
+                         : line.substr(value_start, value_end - value_start + 1);
+  return length;
+}
+
 void CurlDownloader::set_auth_token() {
     std::string token;
     std::cout << "Enter GitHub API token: ";
     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // clear buffer
     std::getline(std::cin, token);
-    this->auth_token = token;
+    tokens = std::make_shared<TokenPool>(std::vector<std::string>{token});
+    rebuildHeaders();
 
     // Save token to .env file
     std::ofstream envFile(".env");
@@ -53,7 +173,7 @@ void CurlDownloader::set_auth_token() {
         std::cerr << "Warning: Could not write to .env file." << std::endl;
     }
 
-    if(auth_token.empty()) {
+    if(token.empty()) {
         std::cerr << "Warning: Authorization token is empty. This may limit API access." << "\n";
     } else {
         std::cout << "Authorization token set successfully." << "\n";
@@ -61,9 +181,16 @@ void CurlDownloader::set_auth_token() {
 }
 
 void CurlDownloader::set_auth_token(const std::string& token) {
-    this->auth_token = token;
-    if(auth_token.empty()) {
+    set_auth_tokens(std::vector<std::string>{token});
+}
+
+void CurlDownloader::set_auth_tokens(const std::vector<std::string>& token_list) {
+    set_token_pool(std::make_shared<TokenPool>(token_list));
+    const bool anonymous = tokens->size() == 1 && tokens->token(0).empty();
+    if (anonymous) {
         std::cerr << "Warning: Authorization token is empty. This may limit API access." << "\n";
+    } else if (tokens->size() > 1) {
+        std::cout << tokens->size() << " authorization tokens set successfully." << "\n";
     } else {
         std::cout << "Authorization token set successfully." << "\n";
     }
@@ -84,6 +211,29 @@ std::string CurlDownloader::urlEncode(const std::string& str_to_encode) {
   return "";
 }
 
+std::string CurlDownloader::buildSearchUrl(const std::string& search_term,
+                                           const std::vector<std::string>& qualifiers,
+                                           int page,
+                                           int page_size) {
+  // Process qualifiers into url format
+  std::string query_components = urlEncode(search_term);
+  for (const std::string& qualifier : qualifiers) {
+      if (!query_components.empty() && !qualifier.empty()) {
+          query_components += "+";
+      }
+      query_components += urlEncode(qualifier); // add the url standard encoding to them
+  }
+
+  // build url
+  std::string full_api_url = api_base_url + "/search/repositories?q=" + query_components;
+  full_api_url += "&per_page=" + std::to_string(page_size);
+
+  if (page > 1) {
+      full_api_url += "&page=" + std::to_string(page);
+  }
+  return full_api_url;
+}
+
 long CurlDownloader::searchRepositories(const std::string& search_term,
                                       const std::vector<std::string>& qualifiers,
                                       std::vector<ProjectInfo>& projects_out,
@@ -96,85 +246,964 @@ long CurlDownloader::searchRepositories(const std::string& search_term,
       std::cerr << "Error: CurlDownloader not properly initialized (curl_handle is null)." << "\n";
       return -1000;
   }
-  
+
+  return searchPage(buildSearchUrl(search_term, qualifiers, page, browsePageSize()), projects_out);
+}
+
+long CurlDownloader::searchPage(const std::string& full_api_url, std::vector<ProjectInfo>& projects_out) {
   // initialize variables
-  std::string read_buffer;
-  long http_code = 0;
-  CURLcode res;
+  HttpFetch fetch;
+  fetch.url = full_api_url;
+  const std::string endpoint = ResponseBufferPool::endpointKey(full_api_url);
+  fetch.body = buffer_pool->acquire(endpoint);
+  fetch.buffer_pool = buffer_pool.get();
+  SearchStreamParser stream(search_fields);
 
-  // Process qualifiers into url format
-  std::string query_components = urlEncode(search_term);
-  for (const std::string& qualifier : qualifiers) {
-      if (!query_components.empty() && !qualifier.empty()) {
-          query_components += "+";
-      }
-      query_components += urlEncode(qualifier); // add the url standard encoding to them
+  std::cout << "CurlDownloader: Making API request to: " << full_api_url << "\n";
+  // revalidate a cached page instead of downloading it again
+  std::string etag = search_cache->conditionalEtag(cacheKey(full_api_url));
+  // items are parsed while the body is still arriving
+  CURLcode res = performSearch(fetch, etag, search_parser == SearchParser::Stream ? &stream : nullptr);
+
+  if (res != CURLE_OK) {
+      std::cerr << "Error: curl_easy_perform() failed: " << curl_easy_strerror(res) << "\n";
+      buffer_pool->release(endpoint, std::move(fetch.body));
+      return (fetch.http_code == 0) ? -static_cast<long>(res) : fetch.http_code;
   }
 
-  // build url
-  std::string full_api_url = "https://api.github.com/search/repositories?q=" + query_components;
-  full_api_url += "&per_page=5";
+  std::cout << "CurlDownloader: Received HTTP Status Code: " << fetch.http_code << "\n";
+  std::cout << "CurlDownloader: Received " << last_transfer.decoded << " bytes ("
+            << last_transfer.wire << " on the wire) after " << last_attempts << " attempt(s)" << "\n";
+  SearchPageMeta meta;
+  long status = completeSearchPage(fetch, projects_out, meta);
+  rememberMeta(full_api_url, meta);
+  buffer_pool->release(endpoint, std::move(fetch.body));
+  return status;
+}
 
-  if (page > 1) {
-      full_api_url += "&page=" + std::to_string(page);
+long CurlDownloader::searchRepositories(const std::string& search_term,
+                                      const std::vector<std::string>& qualifiers,
+                                      SearchPage& page_out,
+                                      int page) {
+  page_out.clear();
+
+  if (!curl_handle) {
+      std::cerr << "Error: CurlDownloader not properly initialized (curl_handle is null)." << "\n";
+      return -1000;
   }
 
-  std::cout << "CurlDownloader: Making API request to: " << full_api_url << "\n";
-  // curl parameters, pretty straight forward in the libcurl doc
-  
-  curl_easy_setopt(curl_handle, CURLOPT_URL, full_api_url.c_str());
-  curl_easy_setopt(curl_handle, CURLOPT_USERAGENT, "MyGitHubClient/1.0");
-  curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, CurlDownloader::write_callback_std_string);
-  curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, &read_buffer);
-  curl_easy_setopt(curl_handle, CURLOPT_FOLLOWLOCATION, 1L);
-  curl_easy_setopt(curl_handle, CURLOPT_TIMEOUT, 30L);
+  HttpFetch fetch;
+  fetch.url = buildSearchUrl(search_term, qualifiers, page, browsePageSize());
+  const std::string endpoint = ResponseBufferPool::endpointKey(fetch.url);
+  fetch.body = buffer_pool->acquire(endpoint);
+  fetch.buffer_pool = buffer_pool.get();
 
-  struct curl_slist* headers = nullptr;
+  std::cout << "CurlDownloader: Making API request to: " << fetch.url << "\n";
+  // unconditional: a 304 could only be answered with the cache's ProjectInfo copies
+  CURLcode res = performSearch(fetch, "", nullptr);
 
-  if(!auth_token.empty()) {
-    std::string auth_header = "Authorization: Bearer " + auth_token;
-    headers = curl_slist_append(headers, auth_header.c_str());
+  if (res != CURLE_OK) {
+      std::cerr << "Error: curl_easy_perform() failed: " << curl_easy_strerror(res) << "\n";
+      buffer_pool->release(endpoint, std::move(fetch.body));
+      return (fetch.http_code == 0) ? -static_cast<long>(res) : fetch.http_code;
   }
 
-  headers = curl_slist_append(headers, "Accept: application/vnd.github.v3+json");
-  
-  curl_easy_setopt(curl_handle, CURLOPT_HTTPHEADER, headers);
+  std::cout << "CurlDownloader: Received HTTP Status Code: " << fetch.http_code << "\n";
+  std::cout << "CurlDownloader: Received " << last_transfer.decoded << " bytes ("
+            << last_transfer.wire << " on the wire) after " << last_attempts << " attempt(s)" << "\n";
 
-  res = curl_easy_perform(curl_handle);
-  curl_easy_getinfo(curl_handle, CURLINFO_RESPONSE_CODE, &http_code);
+  rememberMeta(fetch.url, fetch.http_code == 200 ? SearchPageMeta::parse(fetch.body, fetch.headers) : SearchPageMeta());
+  // the page owns the body from here on; it returns to the pool with the last copy of the page
+  std::shared_ptr<ResponseBufferPool> pool = buffer_pool;
+  std::shared_ptr<std::string> body(new std::string(std::move(fetch.body)), [pool, endpoint](std::string* buffer) {
+      pool->release(endpoint, std::move(*buffer));
+      delete buffer;
+  });
+  if (fetch.http_code == 200 && page_out.parse(body, page_parser)) {
+      std::cout << "CurlDownloader: Successfully parsed " << page_out.size() << " items in place." << "\n";
+      return 200;
+  }
+  std::vector<ProjectInfo> projects;
+  parseSearchResponse(fetch.http_code, *body, projects);
+  page_out.assign(std::move(projects), search_fields);
+  return fetch.http_code;
+}
 
-  if (headers) {
-      curl_slist_free_all(headers);
+long CurlDownloader::searchRepositories(const std::string& search_term,
+                                      const std::vector<std::string>& qualifiers,
+                                      ProjectTable& table_out,
+                                      int page) {
+  SearchPage page_out;
+  long status = searchRepositories(search_term, qualifiers, page_out, page);
+  table_out.append(page_out);
+  return status;
+}
+
+long CurlDownloader::searchRepositories(const std::string& search_term,
+                                      const std::vector<std::string>& qualifiers,
+                                      std::pmr::vector<ProjectInfo>& projects_out,
+                                      int page) {
+  projects_out.clear();
+
+  if (!curl_handle) {
+      std::cerr << "Error: CurlDownloader not properly initialized (curl_handle is null)." << "\n";
+      return -1000;
   }
 
+  HttpFetch fetch;
+  fetch.url = buildSearchUrl(search_term, qualifiers, page, browsePageSize());
+  const std::string endpoint = ResponseBufferPool::endpointKey(fetch.url);
+  fetch.body = buffer_pool->acquire(endpoint);
+  fetch.buffer_pool = buffer_pool.get();
+
+  std::cout << "CurlDownloader: Making API request to: " << fetch.url << "\n";
+  CURLcode res = performSearch(fetch, "", nullptr);
+
+  long status = fetch.http_code;
   if (res != CURLE_OK) {
       std::cerr << "Error: curl_easy_perform() failed: " << curl_easy_strerror(res) << "\n";
-      return (http_code == 0) ? -static_cast<long>(res) : http_code;
+      if (status == 0) status = -static_cast<long>(res);
+  } else {
+      std::cout << "CurlDownloader: Received HTTP Status Code: " << fetch.http_code << "\n";
+      std::cout << "CurlDownloader: Received " << last_transfer.decoded << " bytes ("
+                << last_transfer.wire << " on the wire) after " << last_attempts << " attempt(s)" << "\n";
+      rememberMeta(fetch.url, fetch.http_code == 200 ? SearchPageMeta::parse(fetch.body, fetch.headers) : SearchPageMeta());
+      if (fetch.http_code == 200 && page_parser.parse(fetch.body, projects_out) && page_parser.sawItems()) {
+          std::cout << "CurlDownloader: Successfully parsed " << projects_out.size() << " items." << "\n";
+      } else {
+          parseSearchResponse(fetch.http_code, fetch.body, projects_out);
+      }
+  }
+  buffer_pool->release(endpoint, std::move(fetch.body));
+  return status;
+}
+
+// one search request on the easy handle, repeated as the retry policy allows;
+// conditional when etag is set, stream (if any) is fed the body as it arrives
+CURLcode CurlDownloader::performSearch(HttpFetch& fetch, const std::string& etag, SearchStreamParser* stream) {
+  CURLcode res = CURLE_OK;
+  long& http_code = fetch.http_code;
+  fetch.search_stream = stream;
+
+  // static options and headers were applied once in the constructor
+  curl_easy_setopt(curl_handle, CURLOPT_URL, fetch.url.c_str());
+  curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, CurlDownloader::write_callback_fetch);
+  curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, &fetch);
+  curl_easy_setopt(curl_handle, CURLOPT_HEADERDATA, &fetch.headers);
+
+  for (last_attempts = 1;; ++last_attempts) {
+      fetch.body.clear();
+      fetch.headers.clear();
+      if (stream) stream->reset();
+
+      // hold the request back until some token's search budget allows it
+      const size_t token_index = tokens->acquire("search");
+      struct curl_slist* conditional_headers = nullptr;
+      if (!etag.empty()) {
+          conditional_headers = buildConditionalHeaders(token_index, etag);
+          curl_easy_setopt(curl_handle, CURLOPT_HTTPHEADER, conditional_headers);
+      } else {
+          curl_easy_setopt(curl_handle, CURLOPT_HTTPHEADER, token_headers[token_index]);
+      }
+
+      res = curl_easy_perform(curl_handle);
+      http_code = 0;
+      curl_easy_getinfo(curl_handle, CURLINFO_RESPONSE_CODE, &http_code);
+      last_transfer = finishTransfer(curl_handle, res, fetch.body.size());
+      if (res == CURLE_OK) {
+          tokens->update(token_index, "search", fetch.headers, http_code);
+      }
+
+      if (conditional_headers) {
+          curl_easy_setopt(curl_handle, CURLOPT_HTTPHEADER, token_headers[token_index]);
+          curl_slist_free_all(conditional_headers);
+      }
+
+      if (retry_policy.classify(res, http_code, fetch.headers, fetch.body) != RetryPolicy::Outcome::Retry ||
+          last_attempts >= retry_policy.max_attempts) {
+          break;
+      }
+      std::chrono::milliseconds delay = retry_policy.backoff(last_attempts, fetch.headers);
+      std::cerr << "Warning: Request failed (" << RetryPolicy::describe(res, http_code) << "), retrying in "
+                << delay.count() << " ms (attempt " << (last_attempts + 1) << " of " << retry_policy.max_attempts << ")." << "\n";
+      std::this_thread::sleep_for(delay);
+  }
+  curl_easy_setopt(curl_handle, CURLOPT_HEADERDATA, nullptr);
+  curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, CurlDownloader::write_callback_std_string);
+  fetch.attempts = last_attempts;
+  fetch.result = res;
+  return res;
+}
+
+// turns a finished search request into projects and its meta: a 304 is
+// answered from the cache (reported as 200), a fresh 200 is parsed and cached
+// under its ETag
+long CurlDownloader::completeSearchPage(const HttpFetch& fetch, std::vector<ProjectInfo>& projects_out,
+                                        SearchPageMeta& meta_out) {
+  const long http_code = fetch.http_code;
+  meta_out = SearchPageMeta();
+  if (http_code == 304) {
+      if (search_cache->loadNotModified(cacheKey(fetch.url), projects_out, &meta_out)) {
+          std::cout << "CurlDownloader: Not modified, served " << projects_out.size() << " items from cache." << "\n";
+          return 200;
+      }
+      std::cerr << "Warning: Server answered 304 but the page is no longer cached." << "\n";
+      return http_code;
+  }
+  SearchStreamParser* stream = fetch.search_stream;
+  if (http_code == 200 && stream && stream->finish() && stream->sawItems()) {
+      std::vector<ProjectInfo>& streamed = stream->projects();
+      projects_out.insert(projects_out.end(), std::make_move_iterator(streamed.begin()),
+                          std::make_move_iterator(streamed.end()));
+      streamed.clear();
+      std::cout << "CurlDownloader: Successfully parsed " << projects_out.size() << " items." << "\n";
+  } else if (http_code == 200 && search_parser == SearchParser::Structural &&
+             page_parser.parse(fetch.body, projects_out) && page_parser.sawItems()) {
+      std::cout << "CurlDownloader: Successfully parsed " << projects_out.size() << " items ("
+                << StructuralIndex::name(StructuralIndex::bestIsa()) << " index)." << "\n";
+  } else {
+      // errors, and anything the stream parser couldn't make sense of, take the DOM path
+      parseSearchResponse(http_code, fetch.body, projects_out);
+  }
+  if (http_code == 200) {
+      meta_out = SearchPageMeta::parse(fetch.body, fetch.headers);
+      if (meta_out.incomplete_results) {
+          std::cerr << "Warning: The search timed out; GitHub's results and total_count may be incomplete." << "\n";
+      }
+      auto etag = fetch.headers.find("etag");
+      if (etag != fetch.headers.end()) {
+          search_cache->store(cacheKey(fetch.url), etag->second, projects_out, meta_out);
+      }
+  }
+  return http_code;
+}
+
+// the search URL without its page parameter, which buildSearchUrl() appends last
+static std::string withoutPage(const std::string& url) {
+  const size_t page = url.rfind("&page=");
+  return page == std::string::npos ? url : url.substr(0, page);
+}
+
+void CurlDownloader::rememberMeta(const std::string& url, const SearchPageMeta& meta) {
+  last_meta = meta;
+  last_meta_query = withoutPage(url);
+}
+
+// pages of url's query the last response said exist, -1 if unknown
+int CurlDownloader::knownPageCount(const std::string& url, int page_size) const {
+  if (last_meta_query.empty() || withoutPage(url) != last_meta_query) return -1;
+  return last_meta.pageCount(page_size);
+}
+
+long CurlDownloader::searchRepositoriesRange(const std::string& search_term,
+                                           const std::vector<std::string>& qualifiers,
+                                           int first_page,
+                                           int last_page,
+                                           std::vector<ProjectInfo>& projects_out) {
+  projects_out.clear();
+
+  if (!curl_handle) {
+      std::cerr << "Error: CurlDownloader not properly initialized (curl_handle is null)." << "\n";
+      return -1000;
+  }
+  if (first_page < 1) first_page = 1;
+  if (last_page < first_page) {
+      std::cerr << "Error: searchRepositoriesRange called with last_page < first_page." << "\n";
+      return -1001;
+  }
+
+  return fetchSearchPages(search_term, qualifiers, first_page, last_page, browsePageSize(), projects_out);
+}
+
+long CurlDownloader::searchRepositoriesCount(const std::string& search_term,
+                                           const std::vector<std::string>& qualifiers,
+                                           size_t result_count,
+                                           std::vector<ProjectInfo>& projects_out) {
+  projects_out.clear();
+
+  if (!curl_handle) {
+      std::cerr << "Error: CurlDownloader not properly initialized (curl_handle is null)." << "\n";
+      return -1000;
+  }
+  if (result_count == 0) return 200;
+  if (result_count > MAX_SEARCH_RESULTS) {
+      std::cerr << "Warning: GitHub only returns the first " << MAX_SEARCH_RESULTS << " results of a search." << "\n";
+      result_count = MAX_SEARCH_RESULTS;
+  }
+
+  const int page_size = per_page == ADAPTIVE_PER_PAGE ? adaptivePerPage(result_count) : per_page;
+  const int pages = static_cast<int>((result_count + page_size - 1) / static_cast<size_t>(page_size));
+  std::cout << "CurlDownloader: " << result_count << " results as " << pages << " page(s) of " << page_size << "\n";
+
+  long status = fetchSearchPages(search_term, qualifiers, 1, pages, page_size, projects_out);
+  if (projects_out.size() > result_count) projects_out.resize(result_count);
+  return status;
+}
+
+long CurlDownloader::crawlRepositories(const std::string& search_term,
+                                     const std::vector<std::string>& qualifiers,
+                                     std::vector<ProjectInfo>& projects_out,
+                                     CrawlStats* stats_out) {
+  projects_out.clear();
+
+  if (!curl_handle) {
+      std::cerr << "Error: CurlDownloader not properly initialized (curl_handle is null)." << "\n";
+      return -1000;
+  }
+
+  using Clock = std::chrono::steady_clock;
+  auto elapsedMs = [](Clock::time_point since) {
+      return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+  };
+  const auto crawl_start = Clock::now();
+  const int page_size = browsePageSize();
+  int page_limit = static_cast<int>((MAX_SEARCH_RESULTS + page_size - 1) / static_cast<size_t>(page_size));
+  CrawlStats stats;
+
+  // fetch stage: the request runs on a worker that has the easy handle to
+  // itself until its future is collected, and hands the body back unparsed
+  struct FetchedPage {
+      HttpFetch fetch;
+      double ms = 0;
+  };
+  auto startFetch = [&](int page) {
+      auto fetched = std::make_unique<FetchedPage>();
+      HttpFetch& fetch = fetched->fetch;
+      fetch.url = buildSearchUrl(search_term, qualifiers, page, page_size);
+      fetch.body = buffer_pool->acquire(ResponseBufferPool::endpointKey(fetch.url));
+      fetch.buffer_pool = buffer_pool.get();
+      const std::string etag = search_cache->conditionalEtag(cacheKey(fetch.url));
+      std::cout << "CurlDownloader: Making API request to: " << fetch.url << "\n";
+      return std::async(std::launch::async, [this, etag, elapsedMs](std::unique_ptr<FetchedPage> pending) {
+          const auto start = Clock::now();
+          performSearch(pending->fetch, etag, nullptr);
+          pending->fetch.bytes = last_transfer;
+          pending->ms = elapsedMs(start);
+          return pending;
+      }, std::move(fetched));
+  };
+
+  // parse stage, on this thread while the next page downloads
+  SearchStreamParser stream(search_fields);
+  RepoIdSet emitted(MAX_SEARCH_RESULTS);
+  std::future<std::unique_ptr<FetchedPage>> next = startFetch(1);
+  long status = 200;
+  for (int page = 1; next.valid(); ++page) {
+      std::unique_ptr<FetchedPage> fetched = next.get();
+      HttpFetch& fetch = fetched->fetch;
+      const std::string endpoint = ResponseBufferPool::endpointKey(fetch.url);
+      stats.fetch_ms += fetched->ms;
+      ++stats.pages;
+      if (page == 1) {
+          // the first page tells how many there are (a 304 only if this query was seen last)
+          const SearchPageMeta meta = fetch.http_code == 200 ? SearchPageMeta::parse(fetch.body, fetch.headers) : SearchPageMeta();
+          const int pages = meta.known() ? meta.pageCount(page_size) : knownPageCount(fetch.url, page_size);
+          if (pages >= 0) page_limit = std::min(page_limit, pages);
+      }
+
+      // ask for the next page before parsing this one, unless this one is the last
+      const bool answered = fetch.result == CURLE_OK && (fetch.http_code == 200 || fetch.http_code == 304);
+      if (answered && page < page_limit) next = startFetch(page + 1);
+
+      if (fetch.result != CURLE_OK) {
+          std::cerr << "Error: page " << page << " failed: " << curl_easy_strerror(fetch.result) << "\n";
+          status = (fetch.http_code == 0) ? -static_cast<long>(fetch.result) : fetch.http_code;
+          buffer_pool->release(endpoint, std::move(fetch.body));
+          break;
+      }
+      std::cout << "CurlDownloader: Page " << page << " received HTTP Status Code: " << fetch.http_code
+                << ", " << fetch.bytes.decoded << " bytes (" << fetch.bytes.wire << " on the wire)"
+                << ", " << fetch.attempts << " attempt(s)" << "\n";
+
+      const auto parse_start = Clock::now();
+      if (search_parser == SearchParser::Stream && fetch.http_code == 200) {
+          stream.reset();
+          stream.feed(fetch.body.data(), fetch.body.size());
+          fetch.search_stream = &stream;
+      }
+      std::vector<ProjectInfo> page_projects;
+      SearchPageMeta meta;
+      const long page_status = completeSearchPage(fetch, page_projects, meta);
+      stats.parse_ms += elapsedMs(parse_start);
+      if (page == 1) {
+          rememberMeta(fetch.url, meta);
+          stats.total_count = meta.total_count;
+      }
+      buffer_pool->release(endpoint, std::move(fetch.body));
+      if (page_status != 200) {
+          status = page_status;
+          break;
+      }
+
+      // results move between pages when their ranking changes mid-crawl
+      const size_t received = page_projects.size();
+      stats.duplicates += emitted.appendNew(projects_out, page_projects);
+      if (received < static_cast<size_t>(page_size) || page >= page_limit) break;
+  }
+  if (next.valid()) {
+      // a page asked for ahead of a stop nobody could predict
+      std::unique_ptr<FetchedPage> unused = next.get();
+      buffer_pool->release(ResponseBufferPool::endpointKey(unused->fetch.url), std::move(unused->fetch.body));
+  }
+
+  stats.wall_ms = elapsedMs(crawl_start);
+  if (stats_out) *stats_out = stats;
+  return status;
+}
+
+// total_count of each shard's query, from one-result requests sent together
+long CurlDownloader::probeShards(const std::string& search_term, const std::vector<std::string>& others,
+                                 std::vector<SearchShard*>& shards) {
+  std::vector<HttpFetch> probes(shards.size());
+  for (size_t i = 0; i < shards.size(); ++i) {
+      probes[i].url = buildSearchUrl(search_term, shards[i]->qualifiers(others), 1, 1);
+      probes[i].body = buffer_pool->acquire(ResponseBufferPool::endpointKey(probes[i].url));
+      probes[i].buffer_pool = buffer_pool.get();
+      std::cout << "CurlDownloader: Probing " << probes[i].url << "\n";
+  }
+  if (probes.size() == 1) {
+      performSearch(probes[0], "", nullptr);
+  } else {
+      fetchConcurrent(probes);
+  }
+
+  long status = 200;
+  for (size_t i = 0; i < probes.size(); ++i) {
+      HttpFetch& probe = probes[i];
+      if (status == 200) {
+          if (probe.result != CURLE_OK) {
+              std::cerr << "Error: probe failed: " << curl_easy_strerror(probe.result) << "\n";
+              status = (probe.http_code == 0) ? -static_cast<long>(probe.result) : probe.http_code;
+          } else if (probe.http_code != 200) {
+              std::vector<ProjectInfo> ignored;
+              parseSearchResponse(probe.http_code, probe.body, ignored);  // reports the API's message
+              status = probe.http_code;
+          } else {
+              const SearchPageMeta meta = SearchPageMeta::parse(probe.body, probe.headers);
+              shards[i]->total_count = meta.total_count;
+              if (meta.total_count < 0) {
+                  std::cerr << "Error: search response without a total_count." << "\n";
+                  status = -1002;
+              } else if (meta.incomplete_results) {
+                  std::cerr << "Warning: The search timed out; a shard's total_count of " << meta.total_count
+                            << " may be too low." << "\n";
+              }
+          }
+      }
+      buffer_pool->release(ResponseBufferPool::endpointKey(probe.url), std::move(probe.body));
+  }
+  return status;
+}
+
+long CurlDownloader::planShards(const std::string& search_term,
+                              const std::vector<std::string>& qualifiers,
+                              ShardPlan& plan_out) {
+  plan_out = ShardPlan();
+
+  if (!curl_handle) {
+      std::cerr << "Error: CurlDownloader not properly initialized (curl_handle is null)." << "\n";
+      return -1000;
+  }
+
+  SearchShard root = SearchShard::fromQualifiers(qualifiers, plan_out.qualifiers);
+  std::vector<SearchShard*> probing{&root};
+  ++plan_out.probes;
+  long status = probeShards(search_term, plan_out.qualifiers, probing);
+  if (status != 200) return status;
+  plan_out.total_count = root.total_count;
+
+  const std::int64_t today = static_cast<std::int64_t>(std::time(nullptr)) / 86400;
+  const long long cap = static_cast<long long>(MAX_SEARCH_RESULTS);
+  std::vector<SearchShard> leaves;
+  std::vector<SearchShard> over;
+  (root.total_count > cap ? over : leaves).push_back(root);
+  while (!over.empty()) {
+      // halve every shard over the cap, then measure all the low halves at once
+      std::vector<SearchShard> lows, highs;
+      std::vector<long long> parents;
+      for (const SearchShard& shard : over) {
+          SearchShard low, high;
+          if (!shard.split(low, high, today)) {
+              std::cerr << "Warning: a shard of " << shard.total_count << " results can't be split further; only "
+                        << MAX_SEARCH_RESULTS << " of them are reachable." << "\n";
+              leaves.push_back(shard);
+              continue;
+          }
+          lows.push_back(low);
+          highs.push_back(high);
+          parents.push_back(shard.total_count);
+      }
+      std::vector<SearchShard*> measured;
+      for (SearchShard& low : lows) measured.push_back(&low);
+      plan_out.probes += static_cast<int>(measured.size());
+      if (!measured.empty()) status = probeShards(search_term, plan_out.qualifiers, measured);
+      if (status != 200) return status;
+
+      over.clear();
+      for (size_t i = 0; i < lows.size(); ++i) {
+          highs[i].total_count = std::max(0LL, parents[i] - lows[i].total_count);
+          for (SearchShard* half : {&lows[i], &highs[i]}) (half->total_count > cap ? over : leaves).push_back(*half);
+      }
+  }
+
+  // neighbours that fit under the cap together go back into one shard
+  std::sort(leaves.begin(), leaves.end(), [](const SearchShard& a, const SearchShard& b) {
+      return a.stars_min != b.stars_min ? a.stars_min < b.stars_min : a.created_min < b.created_min;
+  });
+  for (const SearchShard& leaf : leaves) {
+      SearchShard merged;
+      if (!plan_out.shards.empty() && SearchShard::merge(plan_out.shards.back(), leaf, merged) &&
+          merged.total_count <= cap) {
+          plan_out.shards.back() = merged;
+      } else {
+          plan_out.shards.push_back(leaf);
+      }
+  }
+  plan_out.shards.erase(std::remove_if(plan_out.shards.begin(), plan_out.shards.end(),
+                                       [](const SearchShard& shard) { return shard.total_count == 0; }),
+                        plan_out.shards.end());
+  std::cout << "CurlDownloader: " << plan_out.total_count << " results in " << plan_out.shards.size()
+            << " shard(s) after " << plan_out.probes << " probe(s)" << "\n";
+  return 200;
+}
+
+long CurlDownloader::searchRepositoriesSharded(const std::string& search_term,
+                                             const std::vector<std::string>& qualifiers,
+                                             std::vector<ProjectInfo>& projects_out,
+                                             ShardPlan* plan_out) {
+  projects_out.clear();
+  ShardPlan plan;
+  long status = planShards(search_term, qualifiers, plan);
+  if (status != 200) {
+      if (plan_out) *plan_out = std::move(plan);
+      return status;
+  }
+
+  // pages of whole shards are fetched in waves, so a huge query never holds
+  // more than a wave's bodies at once
+  const size_t WAVE_PAGES = 32;
+  RepoIdSet emitted(plan.total_count > 0 ? static_cast<size_t>(plan.total_count) : 0);
+  size_t next_shard = 0;
+  while (next_shard < plan.shards.size() && status == 200) {
+      std::vector<HttpFetch> pages;
+      std::vector<size_t> first_page_of;  // per shard in the wave, index into pages
+      const size_t wave_begin = next_shard;
+      while (next_shard < plan.shards.size() && pages.size() < WAVE_PAGES) {
+          const SearchShard& shard = plan.shards[next_shard++];
+          const size_t count = std::min(static_cast<size_t>(shard.total_count), MAX_SEARCH_RESULTS);
+          const int page_size = per_page == ADAPTIVE_PER_PAGE ? adaptivePerPage(count) : per_page;
+          const int page_count = static_cast<int>((count + page_size - 1) / static_cast<size_t>(page_size));
+          const std::vector<std::string> shard_qualifiers = shard.qualifiers(plan.qualifiers);
+          first_page_of.push_back(pages.size());
+          for (int page = 1; page <= page_count; ++page) {
+              pages.emplace_back();
+              pages.back().url = buildSearchUrl(search_term, shard_qualifiers, page, page_size);
+              pages.back().body = buffer_pool->acquire(ResponseBufferPool::endpointKey(pages.back().url));
+              pages.back().buffer_pool = buffer_pool.get();
+              pages.back().if_none_match = search_cache->conditionalEtag(cacheKey(pages.back().url));
+          }
+      }
+      first_page_of.push_back(pages.size());
+      std::vector<SearchStreamParser> streams(pages.size(), SearchStreamParser(search_fields));
+      for (size_t i = 0; i < pages.size(); ++i) {
+          if (search_parser == SearchParser::Stream) pages[i].search_stream = &streams[i];
+          std::cout << "CurlDownloader: Making API request to: " << pages[i].url << "\n";
+      }
+      plan.page_requests += static_cast<int>(pages.size());
+      fetchConcurrent(pages);
+
+      // each shard's pages in order, up to its first empty page; the first
+      // failed page ends the merge, and its status is the one reported
+      for (size_t s = 0; s + 1 < first_page_of.size() && status == 200; ++s) {
+          for (size_t i = first_page_of[s]; i < first_page_of[s + 1]; ++i) {
+              const HttpFetch& fetch = pages[i];
+              if (fetch.result != CURLE_OK) {
+                  std::cerr << "Error: shard " << (wave_begin + s + 1) << " failed: " << curl_easy_strerror(fetch.result) << "\n";
+                  status = (fetch.http_code == 0) ? -static_cast<long>(fetch.result) : fetch.http_code;
+                  break;
+              }
+              std::vector<ProjectInfo> page_projects;
+              SearchPageMeta meta;
+              const long page_status = completeSearchPage(fetch, page_projects, meta);
+              if (page_status != 200) {
+                  status = page_status;
+                  break;
+              }
+              if (page_projects.empty()) break;
+              // results that moved between shards while they were fetched
+              plan.duplicates += emitted.appendNew(projects_out, page_projects);
+          }
+      }
+      for (HttpFetch& fetch : pages) {
+          buffer_pool->release(ResponseBufferPool::endpointKey(fetch.url), std::move(fetch.body));
+      }
+  }
+  if (plan_out) *plan_out = std::move(plan);
+  return status;
+}
+
+int CurlDownloader::adaptivePerPage(size_t result_count) {
+  if (result_count == 0) return MAX_PER_PAGE;
+  // fewest requests first, then the smallest pages that still need no more of them
+  const size_t pages = (result_count + MAX_PER_PAGE - 1) / MAX_PER_PAGE;
+  return static_cast<int>((result_count + pages - 1) / pages);
+}
+
+int CurlDownloader::browsePageSize() const {
+  return per_page == ADAPTIVE_PER_PAGE ? MAX_PER_PAGE : per_page;
+}
+
+void CurlDownloader::set_per_page(int page_size) {
+  per_page = page_size == ADAPTIVE_PER_PAGE ? ADAPTIVE_PER_PAGE : std::min(std::max(1, page_size), MAX_PER_PAGE);
+}
+
+long CurlDownloader::fetchSearchPages(const std::string& search_term,
+                                    const std::vector<std::string>& qualifiers,
+                                    int first_page,
+                                    int last_page,
+                                    int page_size,
+                                    std::vector<ProjectInfo>& projects_out) {
+  // pages past the end of the result set are never asked for: their number
+  // is known from the last response to this query, or else from the first page
+  const int known_pages = knownPageCount(buildSearchUrl(search_term, qualifiers, first_page, page_size), page_size);
+  if (known_pages >= 0) last_page = std::min(last_page, known_pages);
+  if (first_page > last_page) return 200;
+  if (known_pages < 0 && first_page < last_page) {
+      long status = searchPage(buildSearchUrl(search_term, qualifiers, first_page, page_size), projects_out);
+      if (status != 200 || projects_out.empty()) return status;
+      const int pages = last_meta.pageCount(page_size);
+      if (pages >= 0) last_page = std::min(last_page, pages);
+      if (++first_page > last_page) return 200;
+  }
+  // pages are asked for at different moments, and a result whose ranking
+  // changed in between can turn up on two of them
+  RepoIdSet emitted(projects_out.size() + static_cast<size_t>(last_page - first_page + 1) * static_cast<size_t>(page_size));
+  for (const ProjectInfo& project : projects_out) emitted.insert(project.id);
+  size_t duplicates = 0;
+  if (first_page == last_page) {
+      // nothing to overlap, skip the multi handle
+      std::vector<ProjectInfo> page_projects;
+      long status = searchPage(buildSearchUrl(search_term, qualifiers, first_page, page_size), page_projects);
+      duplicates = emitted.appendNew(projects_out, page_projects);
+      if (duplicates) std::cout << "CurlDownloader: Dropped " << duplicates << " result(s) an earlier page had." << "\n";
+      return status;
+  }
+
+  std::vector<HttpFetch> pages(static_cast<size_t>(last_page - first_page + 1));
+  std::vector<SearchStreamParser> streams(pages.size(), SearchStreamParser(search_fields));
+  for (size_t i = 0; i < pages.size(); ++i) {
+      if (search_parser == SearchParser::Stream) pages[i].search_stream = &streams[i];
+      pages[i].url = buildSearchUrl(search_term, qualifiers, first_page + static_cast<int>(i), page_size);
+      pages[i].body = buffer_pool->acquire(ResponseBufferPool::endpointKey(pages[i].url));
+      pages[i].buffer_pool = buffer_pool.get();
+      pages[i].if_none_match = search_cache->conditionalEtag(cacheKey(pages[i].url));
+      std::cout << "CurlDownloader: Making API request to: " << pages[i].url << "\n";
+  }
+
+  fetchConcurrent(pages);
+
+  // merge in page order, stopping at the first failed or empty page
+  long status = 200;
+  for (size_t i = 0; i < pages.size(); ++i) {
+      const HttpFetch& fetch = pages[i];
+      const int page = first_page + static_cast<int>(i);
+      if (fetch.result != CURLE_OK) {
+          std::cerr << "Error: page " << page << " failed: " << curl_easy_strerror(fetch.result) << "\n";
+          status = (fetch.http_code == 0) ? -static_cast<long>(fetch.result) : fetch.http_code;
+          break;
+      }
+      std::cout << "CurlDownloader: Page " << page << " received HTTP Status Code: " << fetch.http_code
+                << ", " << fetch.bytes.decoded << " bytes (" << fetch.bytes.wire << " on the wire)"
+                << ", " << fetch.attempts << " attempt(s)" << "\n";
+      std::vector<ProjectInfo> page_projects;
+      SearchPageMeta meta;
+      long page_status = completeSearchPage(fetch, page_projects, meta);
+      if (page_status != 200) {
+          status = page_status;
+          break;
+      }
+      if (page_projects.empty()) break;
+      duplicates += emitted.appendNew(projects_out, page_projects);
+  }
+  for (HttpFetch& fetch : pages) {
+      buffer_pool->release(ResponseBufferPool::endpointKey(fetch.url), std::move(fetch.body));
+  }
+  if (duplicates) std::cout << "CurlDownloader: Dropped " << duplicates << " result(s) an earlier page had." << "\n";
+  return status;
+}
+
+void CurlDownloader::fetchConcurrent(std::vector<HttpFetch>& fetches) {
+  if (!curl_handle) {
+      std::cerr << "Error: CurlDownloader not properly initialized (curl_handle is null)." << "\n";
+      return;
+  }
+
+  CURLM* multi_handle = curl_multi_init();
+  if (!multi_handle) {
+      std::cerr << "Error: curl_multi_init() failed." << "\n";
+      for (HttpFetch& fetch : fetches) fetch.result = CURLE_FAILED_INIT;
+      return;
   }
 
-  std::cout << "CurlDownloader: Received HTTP Status Code: " << http_code << "\n";
+  // h2 multiplexes every in-flight request as a stream on one connection;
+  // when the server only speaks HTTP/1.1 the host connection cap turns into a
+  // pool of keep-alive sockets and the remaining requests queue for a free one
+  if (transport.http2) {
+      curl_multi_setopt(multi_handle, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+      curl_multi_setopt(multi_handle, CURLMOPT_MAX_CONCURRENT_STREAMS, transport.max_concurrent_streams);
+  } else {
+      curl_multi_setopt(multi_handle, CURLMOPT_PIPELINING, CURLPIPE_NOTHING);
+  }
+  curl_multi_setopt(multi_handle, CURLMOPT_MAX_HOST_CONNECTIONS, transport.max_host_connections);
+
+  std::vector<CURL*> handles(fetches.size(), nullptr);
+  std::vector<struct curl_slist*> conditional_headers(fetches.size(), nullptr);
+  std::vector<size_t> fetch_tokens(fetches.size(), 0);
+
+  // every handle is a copy of the configured handle (timeouts, share), sent
+  // with the headers of the token the pool picked for it
+  auto start_fetch = [&](size_t index, size_t token_index) -> bool {
+      HttpFetch& fetch = fetches[index];
+      ++fetch.attempts;
+      fetch.result = CURLE_OK;
+      fetch.body.clear();
+      fetch.headers.clear();
+      fetch.http_code = 0;
+      CURL* handle = curl_easy_duphandle(curl_handle);
+      if (!handle) {
+          fetch.result = CURLE_OUT_OF_MEMORY;
+          return false;
+      }
+      session->attach(handle);
+      curl_easy_setopt(handle, CURLOPT_URL, fetch.url.c_str());
+      if (fetch.search_stream) fetch.search_stream->reset();
+      curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, CurlDownloader::write_callback_fetch);
+      curl_easy_setopt(handle, CURLOPT_WRITEDATA, &fetch);
+      curl_easy_setopt(handle, CURLOPT_HEADERDATA, &fetch.headers);
+      fetch_tokens[index] = token_index;
+      if (!fetch.if_none_match.empty()) {
+          // a retry may go out with another token: the previous attempt's list goes
+          if (conditional_headers[index]) curl_slist_free_all(conditional_headers[index]);
+          conditional_headers[index] = buildConditionalHeaders(token_index, fetch.if_none_match);
+          curl_easy_setopt(handle, CURLOPT_HTTPHEADER, conditional_headers[index]);
+      } else {
+          curl_easy_setopt(handle, CURLOPT_HTTPHEADER, token_headers[token_index]);
+      }
+      curl_easy_setopt(handle, CURLOPT_PRIVATE, &fetch);
+      handles[index] = handle;
+      curl_multi_add_handle(multi_handle, handle);
+      return true;
+  };
+
+  using Clock = RateLimitScheduler::Clock;
+  size_t next_fetch = 0;
+  int running = 0;
+  // failed requests waiting out their backoff, and those whose backoff is over
+  std::vector<std::pair<Clock::time_point, size_t>> backing_off;
+  std::deque<size_t> retry_ready;
+
+  // start queued requests (retries first) while the window has room and some
+  // token's rate limit allows, returns how long the pool wants the next one held back
+  auto fill_window = [&]() -> Clock::duration {
+      const Clock::time_point now = Clock::now();
+      for (auto it = backing_off.begin(); it != backing_off.end();) {
+          if (it->first <= now) {
+              retry_ready.push_back(it->second);
+              it = backing_off.erase(it);
+          } else {
+              ++it;
+          }
+      }
+      while ((!retry_ready.empty() || next_fetch < fetches.size()) && running < max_in_flight) {
+          const size_t index = retry_ready.empty() ? next_fetch : retry_ready.front();
+          size_t token_index = 0;
+          auto wait = tokens->reserve(RateLimitScheduler::resourceForUrl(fetches[index].url), token_index);
+          if (wait != Clock::duration::zero()) return wait;
+          if (start_fetch(index, token_index)) ++running;
+          if (retry_ready.empty()) {
+              ++next_fetch;
+          } else {
+              retry_ready.pop_front();
+          }
+      }
+      return Clock::duration::zero();
+  };
+
+  // time until the next backoff expires, zero when nothing is backing off
+  auto next_backoff = [&]() -> Clock::duration {
+      if (backing_off.empty()) return Clock::duration::zero();
+      Clock::time_point earliest = backing_off.front().first;
+      for (const auto& entry : backing_off) earliest = std::min(earliest, entry.first);
+      return std::max<Clock::duration>(earliest - Clock::now(), std::chrono::milliseconds(1));
+  };
+
+  bool multi_failed = false;
+  while (!multi_failed &&
+         (running > 0 || next_fetch < fetches.size() || !backing_off.empty() || !retry_ready.empty())) {
+      auto throttle = fill_window();
+      auto backoff = next_backoff();
+      if (throttle == Clock::duration::zero() ||
+          (backoff != Clock::duration::zero() && backoff < throttle)) {
+          throttle = backoff;
+      }
+      if (running == 0) {
+          // everything left is waiting on the rate limit or a backoff
+          if (throttle != Clock::duration::zero()) std::this_thread::sleep_for(throttle);
+          continue;
+      }
+
+      int still_running = 0;
+      CURLMcode mc = curl_multi_perform(multi_handle, &still_running);
+      if (mc != CURLM_OK) {
+          std::cerr << "Error: curl_multi_perform() failed: " << curl_multi_strerror(mc) << "\n";
+          break;
+      }
+
+      bool finished_any = false;
+      int msgs_left = 0;
+      while (CURLMsg* msg = curl_multi_info_read(multi_handle, &msgs_left)) {
+          if (msg->msg != CURLMSG_DONE) continue;
+          HttpFetch* fetch = nullptr;
+          curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &fetch);
+          fetch->result = msg->data.result;
+          curl_easy_getinfo(msg->easy_handle, CURLINFO_RESPONSE_CODE, &fetch->http_code);
+          fetch->bytes = finishTransfer(msg->easy_handle, fetch->result, fetch->body.size());
+          const size_t index = static_cast<size_t>(fetch - fetches.data());
+          if (fetch->result == CURLE_OK) {
+              tokens->update(fetch_tokens[index], RateLimitScheduler::resourceForUrl(fetch->url),
+                             fetch->headers, fetch->http_code);
+          }
+          curl_multi_remove_handle(multi_handle, msg->easy_handle);
+          curl_easy_cleanup(msg->easy_handle);
+          handles[index] = nullptr;
+          --running;
+          finished_any = true;
+
+          if (retry_policy.classify(fetch->result, fetch->http_code, fetch->headers, fetch->body) ==
+                  RetryPolicy::Outcome::Retry &&
+              fetch->attempts < retry_policy.max_attempts) {
+              std::chrono::milliseconds delay = retry_policy.backoff(fetch->attempts, fetch->headers);
+              std::cerr << "Warning: Request to " << fetch->url << " failed ("
+                        << RetryPolicy::describe(fetch->result, fetch->http_code) << "), retrying in "
+                        << delay.count() << " ms (attempt " << (fetch->attempts + 1) << " of "
+                        << retry_policy.max_attempts << ")." << "\n";
+              backing_off.emplace_back(Clock::now() + delay, index);
+          }
+      }
+
+      // a finished transfer frees a slot, refill before waiting on the sockets
+      if (running > 0 && !finished_any) {
+          long timeout_ms = 1000;
+          if (throttle != RateLimitScheduler::Clock::duration::zero()) {
+              timeout_ms = std::min<long>(timeout_ms, static_cast<long>(
+                  std::chrono::duration_cast<std::chrono::milliseconds>(throttle).count()) + 1);
+          }
+          mc = curl_multi_poll(multi_handle, nullptr, 0, static_cast<int>(timeout_ms), nullptr);
+          if (mc != CURLM_OK) {
+              std::cerr << "Error: curl_multi_poll() failed: " << curl_multi_strerror(mc) << "\n";
+              multi_failed = true;
+          }
+      }
+  }
+
+  // only reached with live handles when the multi loop itself failed
+  for (size_t i = 0; i < handles.size(); ++i) {
+      if (handles[i]) {
+          curl_multi_remove_handle(multi_handle, handles[i]);
+          curl_easy_cleanup(handles[i]);
+          fetches[i].result = CURLE_ABORTED_BY_CALLBACK;
+      }
+  }
+  for (size_t i = next_fetch; i < fetches.size(); ++i) {
+      fetches[i].result = CURLE_ABORTED_BY_CALLBACK;
+  }
+  // retries left queued when the loop failed keep their last error
+  curl_multi_cleanup(multi_handle);
+  for (struct curl_slist* headers : conditional_headers) {
+      if (headers) curl_slist_free_all(headers);
+  }
+}
+
+void CurlDownloader::set_search_cache(std::shared_ptr<SearchCache> cache) {
+  search_cache = cache ? std::move(cache) : std::make_shared<SearchCache>();
+}
+
+void CurlDownloader::set_buffer_pool(std::shared_ptr<ResponseBufferPool> pool) {
+  buffer_pool = pool ? std::move(pool) : std::make_shared<ResponseBufferPool>();
+}
+
+void CurlDownloader::set_token_pool(std::shared_ptr<TokenPool> pool) {
+  tokens = pool ? std::move(pool) : std::make_shared<TokenPool>();
+  rebuildHeaders();
+}
+
+void CurlDownloader::set_retry_policy(const RetryPolicy& policy) {
+  retry_policy = policy;
+  retry_policy.max_attempts = std::max(1, retry_policy.max_attempts);
+}
+
+void CurlDownloader::set_api_base_url(const std::string& base_url) {
+  api_base_url = base_url.empty() ? "https://api.github.com" : base_url;
+  while (api_base_url.size() > 1 && api_base_url.back() == '/') {
+      api_base_url.pop_back();
+  }
+}
+
+void CurlDownloader::set_search_parser(SearchParser parser) {
+  search_parser = parser;
+}
+
+void CurlDownloader::set_search_fields(const SearchFields& fields) {
+  search_fields = fields;
+  page_parser = StructuralSearchParser(search_fields);
+}
+
+// pages parsed with another field set are different cache entries
+std::string CurlDownloader::cacheKey(const std::string& url) const {
+  if (search_fields.isDefault()) return url;
+  std::string key = url + "#fields=";
+  for (const std::string& path : search_fields.paths()) key += path + ",";
+  return key;
+}
+
+void CurlDownloader::set_max_in_flight(int requests) {
+  max_in_flight = std::max(1, requests);
+}
+
+void CurlDownloader::set_transport_options(const TransportOptions& options) {
+  transport = options;
+  transport.max_concurrent_streams = std::max(1L, transport.max_concurrent_streams);
+  transport.max_host_connections = std::max(1L, transport.max_host_connections);
+  applyDefaultOptions();
+}
+
+void CurlDownloader::parseSearchResponse(long http_code, const std::string& read_buffer,
+                                         std::vector<ProjectInfo>& projects_out) {
   if (http_code == 200) {
       try {
           nlohmann::json json_response = nlohmann::json::parse(read_buffer);
 
           if (json_response.contains("items") && json_response["items"].is_array()) {
               for (const auto& item : json_response["items"]) {
+                  if (!search_fields.isDefault()) {
+                      projects_out.push_back(search_fields.extract(item));
+                      continue;
+                  }
                   ProjectInfo project;
-                  project.name = item.value("full_name", "N/A");
+                  project.setName(item.value("full_name", ""));
+                  if (project.name.empty()) project.name = "N/A";
                   project.html_url = item.value("html_url", "N/A");
                   if (item.contains("description") && !item["description"].is_null()) {
                       project.description = item["description"].get<std::string>();
                   } else {
                       project.description = "N/A";
                   }
-                  project.pushed_at = item.value("pushed_at", "N/A");
+                  if (!parseIsoTimestamp(item.value("pushed_at", ""), project.pushed_at)) project.pushed_at = NO_TIMESTAMP;
+                  if (item.contains("id") && item["id"].is_number_integer()) project.id = item["id"].get<std::int64_t>();
                   project.stargazers_count = item.value("stargazers_count", 0);
                   // Add license parsing
                   if (item.contains("license") && item["license"].is_object() && item["license"].contains("spdx_id")) {
-                      project.license = item["license"]["spdx_id"].get<std::string>();
-                      if (project.license == "NOASSERTION") project.license = "No license";
-                  } else {
-                      project.license = "Unknown";
+                      project.license = spdxLicense(item["license"]["spdx_id"].get<std::string>());
                   }
                   projects_out.push_back(project);
               }
@@ -206,7 +1235,26 @@ long CurlDownloader::searchRepositories(const std::string& search_term,
           }
       }
   }
-  return http_code;
+}
+
+// the DOM of a page lives in the same arena as its results; error bodies and
+// malformed pages go through the regular path for its messages
+void CurlDownloader::parseSearchResponse(long http_code, const std::string& read_buffer,
+                                         std::pmr::vector<ProjectInfo>& projects_out) {
+  if (http_code == 200) {
+      std::pmr::memory_resource* resource = projects_out.get_allocator().resource();
+      PageArena::Scope scope(resource);
+      ArenaJson json_response = ArenaJson::parse(read_buffer, nullptr, false);
+      if (!json_response.is_discarded() && json_response.contains("items") && json_response["items"].is_array()) {
+          for (const auto& item : json_response["items"]) {
+              projects_out.push_back(search_fields.extract(item, projects_out.get_allocator()));
+          }
+          std::cout << "CurlDownloader: Successfully parsed " << projects_out.size() << " items." << "\n";
+          return;
+      }
+  }
+  std::vector<ProjectInfo> unused;
+  parseSearchResponse(http_code, read_buffer, unused);
 }
 
 void CurlDownloader::download_url(const std::string& url, const std::string& name) {
@@ -270,8 +1318,6 @@ void CurlDownloader::download_url(const std::string& url, const std::string& nam
         git_repository_free(repo);
     }
 
-    curl_easy_reset(curl_handle);
-
     std::string owner_repo_part;
     size_t github_pos = url.find("github.com/");
     if (github_pos != std::string::npos) {
@@ -1,27 +1,86 @@
 #ifndef CURL_DOWNLOADER_H
 #define CURL_DOWNLOADER_H
 
+#include <memory>
 #include <string>
 #include <vector>
 #include <curl/curl.h>
 #include <git2.h>          // <-- Add this!
 #include "json.hpp"
+#include "curl_session.h"
+#include "http_headers.h"
+#include "project_info.h"
+#include "project_table.h"
+#include "rate_limit_scheduler.h"
+#include "repo_id_set.h"
+#include "response_buffer_pool.h"
+#include "retry_policy.h"
+#include "search_cache.h"
+#include "search_fields.h"
+#include "search_page.h"
+#include "search_page_meta.h"
+#include "search_shard.h"
+#include "search_stream_parser.h"
+#include "structural_search_parser.h"
+#include "token_pool.h"
 
-struct ProjectInfo {
-    std::string name;
-    std::string html_url;
-    std::string description;
-    std::string pushed_at;
-    int stargazers_count;
-    std::string license;
+// How concurrent requests share connections.
+struct TransportOptions {
+    bool http2 = true;                   // negotiate HTTP/2 via ALPN and multiplex requests
+    long max_concurrent_streams = 100;   // streams per HTTP/2 connection
+    long max_host_connections = 6;       // HTTP/1.1 fallback pool size per host
+    std::string ca_file;                 // extra CA bundle, e.g. for a local stand-in server
+};
+
+// How search responses are turned into ProjectInfo. Either way json.hpp's DOM
+// takes over for error bodies and anything the fast path can't parse.
+enum class SearchParser {
+    Stream,       // push parser fed from the write callback while the body arrives
+    Structural    // SIMD structural index over the complete body
+};
+
+// Response body size of one request, as sent by the server (compressed) and
+// after libcurl decoded it into our buffer.
+struct TransferBytes {
+    curl_off_t wire = 0;
+    curl_off_t decoded = 0;
+};
+
+// One request of a fetchConcurrent() batch.
+struct HttpFetch {
+    std::string url;
+    std::string if_none_match;  // sent as a conditional request when set
+    std::string body;
+    HttpHeaders headers;
+    CURLcode result = CURLE_OK;
+    long http_code = 0;
+    TransferBytes bytes;
+    int attempts = 0;           // requests sent, including retries
+    SearchStreamParser* search_stream = nullptr;  // fed the body while it arrives, when set
+    ResponseBufferPool* buffer_pool = nullptr;    // presizes body and counts its growth, when set
+};
+
+// What a crawlRepositories() call did. Fetching and parsing overlap, so
+// fetch_ms + parse_ms exceeds wall_ms by the time the pipeline saved.
+struct CrawlStats {
+    int pages = 0;
+    long long total_count = -1;  // as the first page reported it, -1 if it didn't
+    double fetch_ms = 0;         // waiting on requests, summed over pages
+    double parse_ms = 0;         // turning bodies into ProjectInfo, summed over pages
+    double wall_ms = 0;
+    size_t duplicates = 0;       // results an earlier page already had, dropped
 };
 
 class CurlDownloader {
 public:
-    CurlDownloader();
+    explicit CurlDownloader(std::shared_ptr<CurlSession> session = CurlSession::global());
     ~CurlDownloader();
+    CurlDownloader(const CurlDownloader&) = delete;
+    CurlDownloader& operator=(const CurlDownloader&) = delete;
     void set_auth_token();
     void set_auth_token(const std::string& token);
+    // Spread requests over several tokens, each with its own rate-limit budget.
+    void set_auth_tokens(const std::vector<std::string>& token_list);
     void download_url(const std::string& url, const std::string& name);
 
     // Use git_indexer_progress for the callback
@@ -32,11 +91,182 @@ public:
                             std::vector<ProjectInfo>& projects_out,
                             int page);
 
+    // Same page as views into the response body, which page_out keeps (see
+    // SearchPage). Sent unconditionally, the ETag cache only holds ProjectInfo.
+    long searchRepositories(const std::string& search_term,
+                            const std::vector<std::string>& qualifiers,
+                            SearchPage& page_out,
+                            int page);
+
+    // Same page into a std::pmr::vector, whose resource (normally a PageArena,
+    // reset between pages) also gets the strings and, for the json.hpp
+    // fallback, the DOM. Sent unconditionally too.
+    long searchRepositories(const std::string& search_term,
+                            const std::vector<std::string>& qualifiers,
+                            std::pmr::vector<ProjectInfo>& projects_out,
+                            int page);
+
+    // Same page appended to table_out's columns, straight from the views into
+    // the response body. Sent unconditionally too.
+    long searchRepositories(const std::string& search_term,
+                            const std::vector<std::string>& qualifiers,
+                            ProjectTable& table_out,
+                            int page);
+
+    // Fetch pages first_page..last_page concurrently over curl_multi and
+    // append their results to projects_out in page order. Stops merging at the
+    // first empty or failed page and returns that page's status (200 if all ok).
+    long searchRepositoriesRange(const std::string& search_term,
+                                 const std::vector<std::string>& qualifiers,
+                                 int first_page,
+                                 int last_page,
+                                 std::vector<ProjectInfo>& projects_out);
+
+    // Fetch the first result_count results (at most MAX_SEARCH_RESULTS) in as
+    // few requests as the page size allows.
+    long searchRepositoriesCount(const std::string& search_term,
+                                 const std::vector<std::string>& qualifiers,
+                                 size_t result_count,
+                                 std::vector<ProjectInfo>& projects_out);
+
+    // Every result of a search, up to MAX_SEARCH_RESULTS, as a two-stage
+    // pipeline: page N+1 is in flight on a worker thread while page N is
+    // parsed on this one. Stops at an empty, short or failed page, or once
+    // total_count results are in. Pages hold MAX_PER_PAGE results unless a
+    // fixed page size was set. stats_out, when set, gets the timings.
+    long crawlRepositories(const std::string& search_term,
+                           const std::vector<std::string>& qualifiers,
+                           std::vector<ProjectInfo>& projects_out,
+                           CrawlStats* stats_out = nullptr);
+
+    // Cut a query into shards of at most MAX_SEARCH_RESULTS each: total_count
+    // is probed with one-result requests, and shards over the cap are halved
+    // by stars, then by creation date, probing each level's low halves
+    // together (a high half is what its parent had left). Neighbours that fit
+    // together are merged again and empty shards dropped.
+    long planShards(const std::string& search_term,
+                    const std::vector<std::string>& qualifiers,
+                    ShardPlan& plan_out);
+
+    // Every result of a query, cap or not: the shards of planShards() are
+    // fetched concurrently in as few pages as each needs, and merged in shard
+    // order without duplicates. plan_out, when set, gets the plan and counts.
+    long searchRepositoriesSharded(const std::string& search_term,
+                                   const std::vector<std::string>& qualifiers,
+                                   std::vector<ProjectInfo>& projects_out,
+                                   ShardPlan* plan_out = nullptr);
+
+    static constexpr int MAX_PER_PAGE = 100;            // GitHub's cap on per_page
+    static constexpr int ADAPTIVE_PER_PAGE = 0;
+    static constexpr size_t MAX_SEARCH_RESULTS = 1000;  // results GitHub lets a search page through
+
+    // Results per search request, 1..MAX_PER_PAGE (default 5). ADAPTIVE_PER_PAGE
+    // sizes pages to the result count asked of searchRepositoriesCount and
+    // browses MAX_PER_PAGE at a time otherwise.
+    void set_per_page(int page_size);
+    int getPerPage() const { return per_page; }
+    // Page size of searchRepositories() and crawls: per_page, or
+    // MAX_PER_PAGE when adaptive.
+    int browsePageSize() const;
+    // Page size that fetches result_count results in the fewest requests,
+    // without fetching more than needed to even them out.
+    static int adaptivePerPage(size_t result_count);
+
+    void set_search_parser(SearchParser parser);
+    SearchParser getSearchParser() const { return search_parser; }
+
+    // Fields the search calls extract from each item (default: the six of ProjectInfo).
+    void set_search_fields(const SearchFields& fields);
+    const SearchFields& getSearchFields() const { return search_fields; }
+
+    // Run GET requests against the API concurrently (search pages, repository
+    // metadata, ...), multiplexed over HTTP/2 when the server supports it.
+    void fetchConcurrent(std::vector<HttpFetch>& fetches);
+
+    // Maximum number of requests fetchConcurrent keeps in flight.
+    void set_max_in_flight(int requests);
+    void set_transport_options(const TransportOptions& options);
+
+    // Byte counts of the most recent searchRepositories request.
+    TransferBytes lastTransferBytes() const { return last_transfer; }
+    // Attempts the most recent searchRepositories call needed, including retries.
+    int lastAttempts() const { return last_attempts; }
+    // total_count, incomplete_results and Link pages of the most recent
+    // search call's response (its first page, for the multi-page calls).
+    // The page calls use it to request only pages that exist.
+    const SearchPageMeta& lastPageMeta() const { return last_meta; }
+
+    // API root, "https://api.github.com" unless pointed at GitHub Enterprise or
+    // a local mock (e.g. from GITHUB_API_URL / --api-url).
+    void set_api_base_url(const std::string& base_url);
+    const std::string& getApiBaseUrl() const { return api_base_url; }
+
+    // When and how often failed requests are repeated.
+    void set_retry_policy(const RetryPolicy& policy);
+
+    const CurlSession& getSession() const { return *session; }
+
+    // ETag cache used by the search calls; defaults to the process-wide one.
+    void set_search_cache(std::shared_ptr<SearchCache> cache);
+    const SearchCache& getSearchCache() const { return *search_cache; }
+
+    // Where response bodies are written; defaults to the process-wide pool.
+    void set_buffer_pool(std::shared_ptr<ResponseBufferPool> pool);
+    const ResponseBufferPool& getBufferPool() const { return *buffer_pool; }
+
+    // Tokens requests are sent with, paced by each token's X-RateLimit-* budget.
+    void set_token_pool(std::shared_ptr<TokenPool> pool);
+    const TokenPool& getTokenPool() const { return *tokens; }
+
 private:
     CURL* curl_handle;
-    std::string auth_token;
+    std::shared_ptr<CurlSession> session;
+    std::string api_base_url = "https://api.github.com";
+    std::shared_ptr<SearchCache> search_cache;
+    std::shared_ptr<ResponseBufferPool> buffer_pool;
+    std::shared_ptr<TokenPool> tokens;
+    std::vector<struct curl_slist*> token_headers;  // one prebuilt header list per pool token
+    int max_in_flight = 4;
+    int per_page = 5;
+    SearchFields search_fields;
+    SearchParser search_parser = SearchParser::Stream;
+    StructuralSearchParser page_parser;  // SearchPage and arena results, kept for its index buffers
+    TransportOptions transport;
+    TransferBytes last_transfer;
+    int last_attempts = 0;
+    SearchPageMeta last_meta;
+    std::string last_meta_query;  // search URL last_meta belongs to, without its page
+    RetryPolicy retry_policy;
+    void applyDefaultOptions();
+    void rebuildHeaders();
+    TransferBytes finishTransfer(CURL* handle, CURLcode result, size_t decoded_bytes);
     static size_t write_callback_std_string(void* contents, size_t size, size_t nmemb, std::string* s);
+    static size_t write_callback_fetch(void* contents, size_t size, size_t nmemb, void* userdata);
+    static size_t header_callback(char* buffer, size_t size, size_t nitems, void* userdata);
+    struct curl_slist* buildConditionalHeaders(size_t token_index, const std::string& etag) const;
     std::string urlEncode(const std::string& str_to_encode);
+    std::string buildSearchUrl(const std::string& search_term,
+                               const std::vector<std::string>& qualifiers,
+                               int page,
+                               int page_size);
+    std::string cacheKey(const std::string& url) const;
+    long searchPage(const std::string& full_api_url, std::vector<ProjectInfo>& projects_out);
+    CURLcode performSearch(HttpFetch& fetch, const std::string& etag, SearchStreamParser* stream);
+    long fetchSearchPages(const std::string& search_term,
+                          const std::vector<std::string>& qualifiers,
+                          int first_page,
+                          int last_page,
+                          int page_size,
+                          std::vector<ProjectInfo>& projects_out);
+    long probeShards(const std::string& search_term, const std::vector<std::string>& others,
+                     std::vector<SearchShard*>& shards);
+    void parseSearchResponse(long http_code, const std::string& read_buffer,
+                             std::vector<ProjectInfo>& projects_out);
+    void parseSearchResponse(long http_code, const std::string& read_buffer,
+                             std::pmr::vector<ProjectInfo>& projects_out);
+    long completeSearchPage(const HttpFetch& fetch, std::vector<ProjectInfo>& projects_out, SearchPageMeta& meta_out);
+    void rememberMeta(const std::string& url, const SearchPageMeta& meta);
+    int knownPageCount(const std::string& url, int page_size) const;
 };
 
 #endif
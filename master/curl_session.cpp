@@ -0,0 +1,64 @@
+#include "curl_session.h"
+#include <iostream>
+
+CurlSession::CurlSession(bool share_connections) {
+  share_handle = curl_share_init();
+  if (!share_handle) {
+      std::cerr << "Error: curl_share_init() failed. Requests will not share connections." << "\n";
+      return;
+  }
+  curl_share_setopt(share_handle, CURLSHOPT_LOCKFUNC, CurlSession::lock_cb);
+  curl_share_setopt(share_handle, CURLSHOPT_UNLOCKFUNC, CurlSession::unlock_cb);
+  curl_share_setopt(share_handle, CURLSHOPT_USERDATA, this);
+  curl_share_setopt(share_handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+  curl_share_setopt(share_handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+  if (share_connections) curl_share_setopt(share_handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+}
+
+CurlSession::~CurlSession() {
+  if (share_handle) { curl_share_cleanup(share_handle); }
+}
+
+std::shared_ptr<CurlSession> CurlSession::global() {
+  static std::shared_ptr<CurlSession> session = std::make_shared<CurlSession>();
+  return session;
+}
+
+// libcurl serializes all access to the shared caches through these two callbacks,
+// one mutex per data kind so DNS lookups don't wait on the connection pool.
+void CurlSession::lock_cb(CURL* /*handle*/, curl_lock_data data, curl_lock_access /*access*/, void* userptr) {
+  static_cast<CurlSession*>(userptr)->locks[data].lock();
+}
+
+void CurlSession::unlock_cb(CURL* /*handle*/, curl_lock_data data, void* userptr) {
+  static_cast<CurlSession*>(userptr)->locks[data].unlock();
+}
+
+void CurlSession::attach(CURL* handle) const {
+  if (handle && share_handle) {
+      curl_easy_setopt(handle, CURLOPT_SHARE, share_handle);
+  }
+}
+
+void CurlSession::recordTransfer(CURL* handle, CURLcode result, size_t decoded) {
+  if (result != CURLE_OK) return;
+  long connects = 0;
+  if (curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &connects) != CURLE_OK) return;
+  ++transfers;
+  curl_off_t wire = 0;
+  if (curl_easy_getinfo(handle, CURLINFO_SIZE_DOWNLOAD_T, &wire) == CURLE_OK && wire > 0) {
+      wire_bytes += static_cast<unsigned long long>(wire);
+  }
+  decoded_bytes += decoded;
+  // zero new connections means the request rode on a cached keep-alive socket
+  if (connects == 0) {
+      ++reused_connections;
+  } else {
+      new_connections += static_cast<unsigned long long>(connects);
+  }
+}
+
+CurlSession::Stats CurlSession::stats() const {
+  return Stats{transfers.load(), new_connections.load(), reused_connections.load(),
+               wire_bytes.load(), decoded_bytes.load()};
+}
@@ -0,0 +1,59 @@
+#ifndef CURL_SESSION_H
+#define CURL_SESSION_H
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <curl/curl.h>
+
+// Process-wide libcurl share layer. Every CurlDownloader attaches its easy
+// handles to the same CURLSH, so keep-alive connections, DNS lookups and TLS
+// sessions survive across requests, downloader instances and threads.
+// libcurl doesn't support a shared connection pool used by transfers on
+// several threads at once, so downloaders that run concurrently take a
+// session made with share_connections false: DNS and TLS sessions are still
+// shared, and each easy handle keeps its own connections alive.
+class CurlSession {
+public:
+    struct Stats {
+        unsigned long long transfers;
+        unsigned long long new_connections;
+        unsigned long long reused_connections;
+        unsigned long long wire_bytes;     // response bodies as received, still content-encoded
+        unsigned long long decoded_bytes;  // response bodies after decompression
+    };
+
+    explicit CurlSession(bool share_connections = true);
+    ~CurlSession();
+    CurlSession(const CurlSession&) = delete;
+    CurlSession& operator=(const CurlSession&) = delete;
+
+    // Session shared by every downloader that isn't handed one explicitly.
+    // Must first be called after curl_global_init().
+    static std::shared_ptr<CurlSession> global();
+
+    // Point an easy handle at the shared caches. Needs redoing after curl_easy_reset().
+    void attach(CURL* handle) const;
+
+    // Call after each finished transfer to update the connection reuse and byte
+    // counters. decoded_bytes is what the write callback received. Failed
+    // transfers are not counted.
+    void recordTransfer(CURL* handle, CURLcode result, size_t decoded_bytes);
+
+    Stats stats() const;
+
+private:
+    static void lock_cb(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr);
+    static void unlock_cb(CURL* handle, curl_lock_data data, void* userptr);
+
+    CURLSH* share_handle;
+    std::array<std::mutex, CURL_LOCK_DATA_LAST> locks;
+    std::atomic<unsigned long long> transfers{0};
+    std::atomic<unsigned long long> new_connections{0};
+    std::atomic<unsigned long long> reused_connections{0};
+    std::atomic<unsigned long long> wire_bytes{0};
+    std::atomic<unsigned long long> decoded_bytes{0};
+};
+
+#endif
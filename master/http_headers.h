@@ -0,0 +1,10 @@
+#ifndef HTTP_HEADERS_H
+#define HTTP_HEADERS_H
+
+#include <map>
+#include <string>
+
+// Response headers, names lowercased.
+using HttpHeaders = std::map<std::string, std::string>;
+
+#endif
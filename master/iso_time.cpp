@@ -0,0 +1,162 @@
+#include "iso_time.h"
+#include <cstdio>
+#include <cstring>
+
+// days since 1970-01-01 of a proleptic Gregorian date (Howard Hinnant's algorithm)
+static std::int64_t daysFromCivil(std::int64_t year, unsigned month, unsigned day) {
+  year -= month <= 2;
+  const std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+  const unsigned year_of_era = static_cast<unsigned>(year - era * 400);
+  const unsigned day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+  const unsigned day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+  return era * 146097 + static_cast<std::int64_t>(day_of_era) - 719468;
+}
+
+static void civilFromDays(std::int64_t days, std::int64_t& year, unsigned& month, unsigned& day) {
+  days += 719468;
+  const std::int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+  const unsigned day_of_era = static_cast<unsigned>(days - era * 146097);
+  const unsigned year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+  const unsigned day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+  const unsigned shifted_month = (5 * day_of_year + 2) / 153;
+  day = day_of_year - (153 * shifted_month + 2) / 5 + 1;
+  month = shifted_month < 10 ? shifted_month + 3 : shifted_month - 9;
+  year = static_cast<std::int64_t>(year_of_era) + era * 400 + (month <= 2);
+}
+
+static bool isLeapYear(int year) {
+  return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+// count decimal digits at text[pos], false when any of them isn't one
+static bool readDigits(std::string_view text, size_t pos, size_t count, int& value) {
+  if (pos + count > text.size()) return false;
+  value = 0;
+  for (size_t i = pos; i < pos + count; ++i) {
+      if (text[i] < '0' || text[i] > '9') return false;
+      value = value * 10 + (text[i] - '0');
+  }
+  return true;
+}
+
+// "YYYY-MM-DDTHH:MM:SSZ", the only form the API writes, checked and converted
+// without branches: the 20 bytes are loaded as three words, every digit is
+// validated at once with SWAR arithmetic (xor '0' leaves 0-9 in digit bytes;
+// adding 0x76 sets the top bit of anything larger) and the separators with
+// one masked compare per word. Little-endian only; false sends the caller to
+// the general parser.
+static bool parseFixedTimestamp(const char* text, std::int64_t& seconds) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  std::uint64_t date, time;
+  std::uint32_t tail;
+  std::memcpy(&date, text, 8);       // YYYY-MM-
+  std::memcpy(&time, text + 8, 8);   // DDTHH:MM
+  std::memcpy(&tail, text + 16, 4);  // :SSZ
+
+  // bytes that must be digits, and the separators in the others
+  const std::uint64_t date_digits = 0x00FFFF00FFFFFFFFULL;
+  const std::uint64_t time_digits = 0xFFFF00FFFF00FFFFULL;
+  const std::uint32_t tail_digits = 0x00FFFF00U;
+  const std::uint64_t date_separators = 0x2D0000002D000000ULL;  // '-' at 4 and 7
+  const std::uint64_t time_separators = 0x00003A0000540000ULL;  // 'T' at 2, ':' at 5
+  const std::uint32_t tail_separators = 0x5A00003AU;            // ':' at 0, 'Z' at 3
+
+  const std::uint64_t zeros = 0x3030303030303030ULL;
+  const std::uint64_t date_values = (date ^ zeros) & date_digits;
+  const std::uint64_t time_values = (time ^ zeros) & time_digits;
+  const std::uint32_t tail_values = (tail ^ static_cast<std::uint32_t>(zeros)) & tail_digits;
+  const std::uint64_t above_nine = ((date_values + 0x7676767676767676ULL) | date_values |
+                                    (time_values + 0x7676767676767676ULL) | time_values |
+                                    (tail_values + 0x76767676U) | tail_values) & 0x8080808080808080ULL;
+  const bool shaped = ((date & ~date_digits) == date_separators) & ((time & ~time_digits) == time_separators) &
+                      ((tail & ~tail_digits) == tail_separators) & (above_nine == 0);
+
+  auto digit = [](std::uint64_t values, int index) { return static_cast<unsigned>((values >> (8 * index)) & 0xFF); };
+  const unsigned year = digit(date_values, 0) * 1000 + digit(date_values, 1) * 100 + digit(date_values, 2) * 10 + digit(date_values, 3);
+  const unsigned month = digit(date_values, 5) * 10 + digit(date_values, 6);
+  const unsigned day = digit(time_values, 0) * 10 + digit(time_values, 1);
+  const unsigned hour = digit(time_values, 3) * 10 + digit(time_values, 4);
+  const unsigned minute = digit(time_values, 6) * 10 + digit(time_values, 7);
+  const unsigned second = digit(tail_values, 1) * 10 + digit(tail_values, 2);
+
+  // days before each month in a common year, and the month lengths (index 0 for an invalid month)
+  static const unsigned short DAYS_BEFORE[13] = {0, 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+  static const unsigned char MONTH_DAYS[13] = {0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  const bool leap = ((year % 4 == 0) & (year % 100 != 0)) | (year % 400 == 0);
+  const unsigned month_index = month <= 12 ? month : 0;
+  const unsigned month_days = MONTH_DAYS[month_index] + (leap & (month == 2));
+  const bool valid = shaped & (month - 1 < 12) & (day - 1 < month_days) & (hour < 24) & (minute < 60) & (second <= 60);
+
+  // whole years since 0000-01-01 shifted by one 400-year cycle, so a
+  // year-0 date still counts in unsigned arithmetic
+  const unsigned years = year + 399;
+  const unsigned day_number = years * 365 + years / 4 - years / 100 + years / 400 + DAYS_BEFORE[month_index] +
+                              ((month > 2) & leap) + day - 1;
+  const std::int64_t days = static_cast<std::int64_t>(day_number) - 146097 - 719162;
+  seconds = valid ? days * 86400 + hour * 3600 + minute * 60 + second : seconds;
+  return valid;
+#else
+  (void)text;
+  (void)seconds;
+  return false;
+#endif
+}
+
+bool parseIsoTimestamp(std::string_view text, std::int64_t& seconds) {
+  if (text.size() == 20 && parseFixedTimestamp(text.data(), seconds)) return true;
+
+  int year, month, day, hour, minute, second;
+  if (text.size() < 19 || !readDigits(text, 0, 4, year) || text[4] != '-' || !readDigits(text, 5, 2, month) ||
+      text[7] != '-' || !readDigits(text, 8, 2, day) || (text[10] != 'T' && text[10] != 't' && text[10] != ' ') ||
+      !readDigits(text, 11, 2, hour) || text[13] != ':' || !readDigits(text, 14, 2, minute) || text[16] != ':' ||
+      !readDigits(text, 17, 2, second)) {
+      return false;
+  }
+  static const int DAYS_IN_MONTH[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  if (month < 1 || month > 12 || day < 1 || hour > 23 || minute > 59 || second > 60) return false;
+  if (day > DAYS_IN_MONTH[month - 1] + (month == 2 && isLeapYear(year))) return false;
+
+  size_t pos = 19;
+  if (pos < text.size() && (text[pos] == '.' || text[pos] == ',')) {
+      const size_t fraction = ++pos;
+      while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') ++pos;
+      if (pos == fraction) return false;
+  }
+  int offset = 0;
+  if (pos < text.size()) {
+      if (text[pos] == 'Z' || text[pos] == 'z') {
+          ++pos;
+      } else if (text[pos] == '+' || text[pos] == '-') {
+          int offset_hours, offset_minutes;
+          const bool colon = pos + 3 < text.size() && text[pos + 3] == ':';
+          if (!readDigits(text, pos + 1, 2, offset_hours) || !readDigits(text, pos + (colon ? 4 : 3), 2, offset_minutes) ||
+              offset_hours > 23 || offset_minutes > 59) {
+              return false;
+          }
+          offset = (offset_hours * 60 + offset_minutes) * 60 * (text[pos] == '-' ? -1 : 1);
+          pos += colon ? 6 : 5;
+      }
+  }
+  if (pos != text.size()) return false;
+
+  seconds = daysFromCivil(year, static_cast<unsigned>(month), static_cast<unsigned>(day)) * 86400 +
+            hour * 3600 + minute * 60 + second - offset;
+  return true;
+}
+
+std::string formatIsoTimestamp(std::int64_t seconds) {
+  std::int64_t days = seconds / 86400;
+  std::int64_t time_of_day = seconds % 86400;
+  if (time_of_day < 0) {
+      time_of_day += 86400;
+      --days;
+  }
+  std::int64_t year;
+  unsigned month, day;
+  civilFromDays(days, year, month, day);
+  char text[48];
+  std::snprintf(text, sizeof(text), "%04lld-%02u-%02uT%02d:%02d:%02dZ", static_cast<long long>(year), month, day,
+                static_cast<int>(time_of_day / 3600), static_cast<int>(time_of_day / 60 % 60),
+                static_cast<int>(time_of_day % 60));
+  return text;
+}
@@ -0,0 +1,22 @@
+#ifndef ISO_TIME_H
+#define ISO_TIME_H
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+
+// Timestamps as the API writes them ("2024-05-01T12:34:56Z") <-> seconds
+// since the Unix epoch, UTC, so records can sort and filter on an integer.
+
+// Stands for a missing or unparseable timestamp; sorts before every real one.
+constexpr std::int64_t NO_TIMESTAMP = std::numeric_limits<std::int64_t>::min();
+
+// ISO-8601 date-time: YYYY-MM-DDTHH:MM:SS, optional fraction (dropped), then Z,
+// +hh:mm / -hh:mm or nothing (taken as UTC). False when text isn't one.
+bool parseIsoTimestamp(std::string_view text, std::int64_t& seconds);
+
+// "YYYY-MM-DDTHH:MM:SSZ"
+std::string formatIsoTimestamp(std::int64_t seconds);
+
+#endif
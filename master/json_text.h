@@ -0,0 +1,112 @@
+#ifndef JSON_TEXT_H
+#define JSON_TEXT_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Small pieces of JSON lexing shared by the hand-written search parsers.
+
+// Emit code point code as UTF-8 through put(char).
+template <typename Put>
+inline void putUtf8(Put&& put, unsigned code) {
+    if (code < 0x80) {
+        put(static_cast<char>(code));
+    } else if (code < 0x800) {
+        put(static_cast<char>(0xC0 | (code >> 6)));
+        put(static_cast<char>(0x80 | (code & 0x3F)));
+    } else if (code < 0x10000) {
+        put(static_cast<char>(0xE0 | (code >> 12)));
+        put(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+        put(static_cast<char>(0x80 | (code & 0x3F)));
+    } else {
+        put(static_cast<char>(0xF0 | (code >> 18)));
+        put(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+        put(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+        put(static_cast<char>(0x80 | (code & 0x3F)));
+    }
+}
+
+// Append code point code to out as UTF-8.
+inline void appendUtf8(std::string& out, unsigned code) {
+    putUtf8([&out](char c) { out += c; }, code);
+}
+
+// true, false, null or something shaped like a number.
+inline bool isJsonLiteral(std::string_view text) {
+    if (text == "null" || text == "true" || text == "false") return true;
+    if (text.empty() || !(text[0] == '-' || (text[0] >= '0' && text[0] <= '9'))) return false;
+    return text.find_first_not_of("0123456789+-.eE") == std::string_view::npos;
+}
+
+// Decode the contents of a string literal (without its quotes) through
+// put(char). Each character is emitted only after its escape has been read in
+// full. False on a malformed escape or an unpaired surrogate, which json.hpp
+// rejects too.
+template <typename Put>
+inline bool decodeJsonString(const char* begin, const char* end, Put&& put) {
+    unsigned high_surrogate = 0;  // a \uD800-\uDBFF waiting for the \uDC00-\uDFFF right after it
+    for (const char* p = begin; p < end; ++p) {
+        if (*p != '\\') {
+            if (high_surrogate) return false;
+            put(*p);
+            continue;
+        }
+        if (++p == end || (high_surrogate && *p != 'u')) return false;
+        switch (*p) {
+            case '"': put('"'); break;
+            case '\\': put('\\'); break;
+            case '/': put('/'); break;
+            case 'b': put('\b'); break;
+            case 'f': put('\f'); break;
+            case 'n': put('\n'); break;
+            case 'r': put('\r'); break;
+            case 't': put('\t'); break;
+            case 'u': {
+                if (end - p < 5) return false;
+                unsigned code = 0;
+                for (int i = 1; i <= 4; ++i) {
+                    const char c = p[i];
+                    code <<= 4;
+                    if (c >= '0' && c <= '9') code |= static_cast<unsigned>(c - '0');
+                    else if (c >= 'a' && c <= 'f') code |= static_cast<unsigned>(c - 'a' + 10);
+                    else if (c >= 'A' && c <= 'F') code |= static_cast<unsigned>(c - 'A' + 10);
+                    else return false;
+                }
+                p += 4;
+                if (code >= 0xD800 && code <= 0xDBFF) {
+                    if (high_surrogate) return false;
+                    high_surrogate = code;
+                    continue;
+                }
+                const bool low_surrogate = code >= 0xDC00 && code <= 0xDFFF;
+                if (low_surrogate != (high_surrogate != 0)) return false;
+                if (low_surrogate) code = 0x10000 + ((high_surrogate - 0xD800) << 10) + (code - 0xDC00);
+                putUtf8(put, code);
+                break;
+            }
+            default:
+                return false;
+        }
+        high_surrogate = 0;
+    }
+    return high_surrogate == 0;
+}
+
+// Decode the contents of a string literal (without its quotes) into out.
+// False on a malformed escape or an unpaired surrogate.
+inline bool unescapeJson(const char* begin, const char* end, std::string& out) {
+    out.clear();
+    return decodeJsonString(begin, end, [&out](char c) { out += c; });
+}
+
+// Decode [begin, end) over itself, which works because no escape decodes to
+// more bytes than it is written with. Returns the new end, null on a
+// malformed escape or an unpaired surrogate.
+inline char* unescapeJsonInPlace(char* begin, char* end) {
+    char* out = begin;
+    if (!decodeJsonString(begin, end, [&out](char c) { *out++ = c; })) return nullptr;
+    return out;
+}
+
+#endif
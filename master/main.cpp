@@ -7,6 +7,8 @@
 #include <fstream>
 #include <sstream>
 #include <cstdlib>
+#include <ctime>
+#include <stdexcept>
 
 #include "curl_downloader.h" 
 #include <curl/curl.h>
@@ -72,10 +74,42 @@ void loadDotEnv(const std::string& filename = ".env") {
 }    
 
 
-int main() {
+// -n/--per-page: 1 to MAX_PER_PAGE, or "auto"; false for anything else
+bool parsePerPage(const std::string& value, int& per_page) {
+    if (value == "auto") {
+        per_page = CurlDownloader::ADAPTIVE_PER_PAGE;
+        return true;
+    }
+    try {
+        size_t used = 0;
+        per_page = std::stoi(value, &used);
+        return used == value.size() && per_page >= 1 && per_page <= CurlDownloader::MAX_PER_PAGE;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+int main(int argc, char* argv[]) {
   // Load environment variables from .env file
   loadDotEnv();
 
+  // results per page: -n/--per-page N (1-100) or "auto" for the largest page size
+  int per_page {-1};
+  for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      if ((arg == "-n" || arg == "--per-page") && i + 1 < argc) {
+          std::string value = argv[++i];
+          if (!parsePerPage(value, per_page)) {
+              std::cerr << "Error: -n takes 1 to " << CurlDownloader::MAX_PER_PAGE << " or auto, not \"" << value << "\"" << "\n";
+              std::cerr << "Usage: github-searcher [-n per_page|auto]" << "\n";
+              return 1;
+          }
+      } else if (arg == "-h" || arg == "--help") {
+          std::cout << "Usage: github-searcher [-n per_page|auto]" << "\n";
+          return 0;
+      }
+  }
+
   // Store found repositories
   std::vector<ProjectInfo> found_projects;
   std::string searchTerm {};
@@ -96,11 +130,20 @@ int main() {
   std::cout << "Network components initialized successfully." << '\n';
 
   CurlDownloader downloader;
+  if (per_page != -1) {
+      downloader.set_per_page(per_page);
+  }
 
-  const char* env_token = std::getenv("GITHUB_TOKEN");
-  if (env_token && std::string(env_token).length() > 0) {
-      downloader.set_auth_token(std::string(env_token));
-      std::cout << "GitHub API token loaded from environment." << '\n';
+  const char* env_api_url = std::getenv("GITHUB_API_URL");
+  if (env_api_url && std::string(env_api_url).length() > 0) {
+      downloader.set_api_base_url(env_api_url);
+      std::cout << "Using API at " << downloader.getApiBaseUrl() << '\n';
+  }
+
+  const std::vector<std::string> env_tokens = TokenPool::tokensFromEnvironment();
+  if (!env_tokens.empty()) {
+      downloader.set_auth_tokens(env_tokens);
+      std::cout << env_tokens.size() << " GitHub API token(s) loaded from environment." << '\n';
   } else {
       std::cout << "No GitHub API token found in environment. You can set it with the 'at' command." << '\n';
   }
@@ -116,6 +159,7 @@ int main() {
       std::string mode {};
       printSubHeader("Options: \"download\", \"search\", \"exit\",");
       printSubHeader("\"pp (previous page)\", \"at (auth token), \"np (next page).\"");
+      printSubHeader("\"stats (connection and cache statistics)\"");
       std::cout << '\n';
       printSeparator();
       std::cout << " > ";
@@ -137,7 +181,8 @@ int main() {
         --download_int;
 
         if (download_int < found_projects.size()) {
-          downloader.download_url(found_projects[download_int].html_url, found_projects[download_int].name);
+          downloader.download_url(std::string(found_projects[download_int].html_url),
+                                  std::string(found_projects[download_int].name));
           printSeparator();
           clearInputBuffer();
         } else if (download_int < 0) {
@@ -158,11 +203,41 @@ int main() {
         // Set authorization token for GitHub API
         printSubHeader("Please input your Authorization Token");
         downloader.set_auth_token();
+      } else if (mode == "stats") {
+        // Show how much the connection and response caches saved so far
+        const CurlSession::Stats conn = downloader.getSession().stats();
+        const SearchCache::Stats cache = downloader.getSearchCache().stats();
+        printSubHeader("Statistics");
+        std::cout << "  " << std::left << std::setw(24) << "Requests:" << conn.transfers << "\n";
+        std::cout << "  " << std::left << std::setw(24) << "Connections opened:" << conn.new_connections << "\n";
+        std::cout << "  " << std::left << std::setw(24) << "Connections reused:" << conn.reused_connections << "\n";
+        std::cout << "  " << std::left << std::setw(24) << "Bytes on the wire:" << conn.wire_bytes << "\n";
+        std::cout << "  " << std::left << std::setw(24) << "Bytes decoded:" << conn.decoded_bytes << "\n";
+        std::cout << "  " << std::left << std::setw(24) << "Cache hits:" << cache.hits << " of " << cache.requests
+                  << " (" << cache.conditional << " revalidated)" << "\n";
+        std::cout << "  " << std::left << std::setw(24) << "Rate-limit units saved:" << cache.rate_limit_units_saved << "\n";
+        const RateLimitScheduler::Budget budget = downloader.getTokenPool().budget("search");
+        const RateLimitScheduler::Stats pacing = downloader.getTokenPool().stats();
+        if (budget.remaining >= 0) {
+            std::cout << "  " << std::left << std::setw(24) << "Search budget left:" << budget.remaining << " of " << budget.limit << "\n";
+        }
+        std::cout << "  " << std::left << std::setw(24) << "Requests paced:" << pacing.delayed
+                  << " (" << pacing.waited.count() << " ms waited)" << "\n";
+        printSeparator();
       } else if (mode == "exit") { 
         // Exit the application
         exit(0);
       } else if (mode == "np" || mode == "pp") {
-        // Handle pagination: next/previous page
+        // Handle pagination: next/previous page, never asking for one past the end
+        const int page_count = downloader.lastPageMeta().pageCount(downloader.browsePageSize());
+        if (mode == "pp" && page <= 1) {
+          std::cout << "Already at the first page." << std::endl;
+          continue;
+        }
+        if (mode == "np" && page_count >= 0 && page >= page_count) {
+          std::cout << "No more results: page " << page << " is the last of " << page_count << "." << std::endl;
+          continue;
+        }
         ++page; 
         if (mode == "pp") { page -= 2; } // Go to previous page
         found_projects.clear();
@@ -190,7 +265,7 @@ int main() {
                 std::cout << "  " << std::left << std::setw(15) << "URL:" << project.html_url << "\n";
                 
                 // Handle description formatting
-                std::string desc = project.description;
+                std::string desc(project.description);
                 if (desc.empty() || desc == "N/A") {
                     desc = "No description provided.";
                 } else if (desc.length() > 100) { // Truncate long descriptions for console
@@ -198,8 +273,8 @@ int main() {
                 }
                 std::cout << "  " << std::left << std::setw(15) << "Description:" << desc << "\n";
                 std::cout << "  " << std::left << std::setw(15) << "Stars:" << project.stargazers_count << "\n";
-                std::cout << "  " << std::left << std::setw(15) << "Last Push:" << project.pushed_at << "\n";
-                std::cout << "  " << std::left << std::setw(15) << "License:" << project.license << "\n";
+                std::cout << "  " << std::left << std::setw(15) << "Last Push:" << project.pushedAtText() << "\n";
+                std::cout << "  " << std::left << std::setw(15) << "License:" << project.licenseName() << "\n";
                 if (i < found_projects.size() - 1) {
                     printSeparator('.');
                 }
@@ -261,6 +336,11 @@ int main() {
             std::cout << "Found " << found_projects.size() << " repository/repositories." << "\n";
             printSeparator();
             std::cout << "PG: (" << page << ")";
+            const SearchPageMeta& meta = downloader.lastPageMeta();
+            if (meta.total_count >= 0) {
+                std::cout << " of " << meta.pageCount(downloader.browsePageSize()) << ", " << meta.total_count
+                          << (meta.incomplete_results ? "+" : "") << " results";
+            }
             printSeparator();
             for (size_t i = 0; i < found_projects.size(); ++i) {
                 const auto& project = found_projects[i];
@@ -269,7 +349,7 @@ int main() {
                 std::cout << "  " << std::left << std::setw(15) << "URL:" << project.html_url << "\n";
                 
                 // Handle description formatting
-                std::string desc = project.description;
+                std::string desc(project.description);
                 if (desc.empty() || desc == "N/A") {
                     desc = "No description provided.";
                 } else if (desc.length() > 100) { // Truncate long descriptions for console
@@ -277,8 +357,8 @@ int main() {
                 }
                 std::cout << "  " << std::left << std::setw(15) << "Description:" << desc << "\n";
                 std::cout << "  " << std::left << std::setw(15) << "Stars:" << project.stargazers_count << "\n";
-                std::cout << "  " << std::left << std::setw(15) << "Last Push:" << project.pushed_at << "\n";
-                std::cout << "  " << std::left << std::setw(15) << "License:" << project.license << "\n";
+                std::cout << "  " << std::left << std::setw(15) << "Last Push:" << project.pushedAtText() << "\n";
+                std::cout << "  " << std::left << std::setw(15) << "License:" << project.licenseName() << "\n";
                 if (i < found_projects.size() - 1) {
                     printSeparator('.');
                 }
@@ -290,6 +370,14 @@ int main() {
         std::cerr << "This could be due to various reasons:" << "\n";
         std::cerr << "  - Invalid search query or qualifiers." << "\n";
         std::cerr << "  - API rate limiting (if you've made too many requests)." << "\n";
+        const RateLimitScheduler::Budget budget = downloader.getTokenPool().budget("search");
+        if (budget.remaining >= 0) {
+            std::cerr << "    Search budget: " << budget.remaining << " of " << budget.limit << " requests left";
+            if (budget.reset > 0) {
+                std::cerr << ", resets at " << std::put_time(std::localtime(&budget.reset), "%H:%M:%S");
+            }
+            std::cerr << "." << "\n";
+        }
         std::cerr << "  - GitHub API changes or temporary unavailability." << "\n";
         std::cerr << "  - Network issues preventing a successful connection to GitHub." << "\n";
         std::cerr << "Please check your search terms. If you are rate-limited, try again later." << "\n";
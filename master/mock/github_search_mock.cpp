@@ -0,0 +1,654 @@
+// Stand-in for GitHub's /search/repositories endpoint, so the client can be
+// benchmarked on a machine without network access.
+//
+//   github-search-mock [--port 8089] [--fixtures DIR] [--total N]
+//                      [--latency MS] [--jitter MS]
+//                      [--rate-limit N] [--window SECONDS]
+//                      [--error-rate P] [--error-code CODE]
+//
+// Page N is served from DIR/page-N.json when --fixtures is given (recorded
+// responses), otherwise a page of synthetic items shaped like GitHub's is
+// generated for a result set of --total repositories, narrowed by any stars:
+// and created: range in q (stars fall and creation dates rise with an item's
+// index, so a range selects a contiguous run). Responses carry an
+// ETag (If-None-Match gets a 304), a Link header and, with --rate-limit,
+// X-RateLimit-* headers and 403s once a window's budget is spent; as on
+// GitHub, a 304 doesn't count against it. Each request
+// is delayed by latency +/- jitter and fails with --error-code with
+// probability --error-rate.
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <csignal>
+#include <exception>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "json.hpp"
+
+struct MockOptions {
+    int port = 8089;
+    std::string fixtures;
+    long total = 1000;
+    int latency_ms = 0;
+    int jitter_ms = 0;
+    long rate_limit = 0;  // 0 = no X-RateLimit headers
+    long window_s = 60;
+    double error_rate = 0.0;
+    int error_code = 503;
+};
+
+struct HttpRequest {
+    std::string method;
+    std::string path;
+    std::map<std::string, std::string> query;
+    std::map<std::string, std::string> headers;  // names lowercased
+};
+
+struct HttpResponse {
+    int status = 200;
+    std::vector<std::pair<std::string, std::string>> headers;
+    std::string body;
+};
+
+class RateWindow {
+public:
+    explicit RateWindow(long limit, long window_s) : limit(limit), window_s(window_s) {}
+
+    // Take one unit, fills in the headers GitHub would send. False once the window is spent.
+    bool take(HttpResponse& response) { return charge(response, 1); }
+    // The headers alone, for a response that costs nothing.
+    void report(HttpResponse& response) { charge(response, 0); }
+
+private:
+    bool charge(HttpResponse& response, long cost) {
+        std::lock_guard<std::mutex> lock(mutex);
+        const std::time_t now = std::time(nullptr);
+        if (reset == 0 || now >= reset) {
+            reset = now + window_s;
+            used = 0;
+        }
+        const bool allowed = used + cost <= limit;
+        if (allowed) used += cost;
+        response.headers.emplace_back("X-RateLimit-Limit", std::to_string(limit));
+        response.headers.emplace_back("X-RateLimit-Remaining", std::to_string(limit - used));
+        response.headers.emplace_back("X-RateLimit-Reset", std::to_string(reset));
+        response.headers.emplace_back("X-RateLimit-Used", std::to_string(used));
+        response.headers.emplace_back("X-RateLimit-Resource", "search");
+        if (!allowed) response.headers.emplace_back("Retry-After", std::to_string(reset - now));
+        return allowed;
+    }
+
+    std::mutex mutex;
+    long limit;
+    long window_s;
+    std::time_t reset = 0;
+    long used = 0;
+};
+
+static int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// everything but the unreserved characters as %XX, as curl_easy_escape does
+static std::string urlEncode(const std::string& in) {
+    static const char hex[] = "0123456789ABCDEF";
+    std::string out;
+    for (char c : in) {
+        const unsigned char byte = static_cast<unsigned char>(c);
+        if (std::isalnum(byte) || c == '-' || c == '.' || c == '_' || c == '~') {
+            out += c;
+        } else {
+            out += '%';
+            out += hex[byte >> 4];
+            out += hex[byte & 0x0F];
+        }
+    }
+    return out;
+}
+
+// a '%' not followed by two hex digits is kept as written
+static std::string urlDecode(const std::string& in) {
+    std::string out;
+    for (size_t i = 0; i < in.size(); ++i) {
+        const int high = in[i] == '%' && i + 2 < in.size() ? hexValue(in[i + 1]) : -1;
+        const int low = high >= 0 ? hexValue(in[i + 2]) : -1;
+        if (in[i] == '+') {
+            out += ' ';
+        } else if (low >= 0) {
+            out += static_cast<char>(high * 16 + low);
+            i += 2;
+        } else {
+            out += in[i];
+        }
+    }
+    return out;
+}
+
+static bool parseRequest(const std::string& head, HttpRequest& request) {
+    std::istringstream lines(head);
+    std::string line;
+    if (!std::getline(lines, line)) return false;
+    std::istringstream request_line(line);
+    std::string target;
+    request_line >> request.method >> target;
+    if (request.method.empty() || target.empty()) return false;
+
+    size_t question = target.find('?');
+    request.path = target.substr(0, question);
+    if (question != std::string::npos) {
+        std::istringstream params(target.substr(question + 1));
+        std::string pair;
+        while (std::getline(params, pair, '&')) {
+            size_t eq = pair.find('=');
+            if (eq == std::string::npos) continue;
+            request.query[pair.substr(0, eq)] = urlDecode(pair.substr(eq + 1));
+        }
+    }
+
+    while (std::getline(lines, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) continue;
+        std::string name = line.substr(0, colon);
+        std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+        size_t value = line.find_first_not_of(' ', colon + 1);
+        request.headers[name] = value == std::string::npos ? "" : line.substr(value);
+    }
+    return true;
+}
+
+static long queryLong(const HttpRequest& request, const std::string& name, long fallback) {
+    auto it = request.query.find(name);
+    if (it == request.query.end()) return fallback;
+    try {
+        return std::stol(it->second);
+    } catch (const std::exception&) {
+        return fallback;
+    }
+}
+
+static long syntheticStars(long index) {
+    return std::max(0L, 200000 - index * 17);
+}
+
+static std::time_t syntheticCreated(long index) {
+    return 1230768000 + index * 2903;  // from 2009-01-01, about 30 a day
+}
+
+// one repository shaped like a real search item, owner object and *_url fields included
+static nlohmann::json syntheticItem(long index) {
+    static const char* licenses[] = {"MIT", "Apache-2.0", "GPL-3.0", "BSD-3-Clause", "NOASSERTION"};
+    static const char* languages[] = {"C++", "C", "Rust", "Go", "Python"};
+    const std::string owner = "owner" + std::to_string(index % 97);
+    const std::string name = "repo-" + std::to_string(index);
+    const std::string full_name = owner + "/" + name;
+    const std::string api = "https://api.github.com/repos/" + full_name;
+
+    char pushed_at[32];
+    std::time_t pushed = 1700000000 - index * 3607;
+    std::strftime(pushed_at, sizeof(pushed_at), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&pushed));
+    char created_at[32];
+    std::time_t created = syntheticCreated(index);
+    std::strftime(created_at, sizeof(created_at), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&created));
+
+    nlohmann::json item = {
+        {"id", 100000 + index},
+        {"node_id", "R_kgDO" + std::to_string(index)},
+        {"name", name},
+        {"full_name", full_name},
+        {"private", false},
+        {"owner", {
+            {"login", owner},
+            {"id", 5000 + index % 97},
+            {"node_id", "U_kgDO" + std::to_string(index % 97)},
+            {"avatar_url", "https://avatars.githubusercontent.com/u/" + std::to_string(5000 + index % 97) + "?v=4"},
+            {"gravatar_id", ""},
+            {"url", "https://api.github.com/users/" + owner},
+            {"html_url", "https://github.com/" + owner},
+            {"followers_url", "https://api.github.com/users/" + owner + "/followers"},
+            {"following_url", "https://api.github.com/users/" + owner + "/following{/other_user}"},
+            {"gists_url", "https://api.github.com/users/" + owner + "/gists{/gist_id}"},
+            {"starred_url", "https://api.github.com/users/" + owner + "/starred{/owner}{/repo}"},
+            {"subscriptions_url", "https://api.github.com/users/" + owner + "/subscriptions"},
+            {"organizations_url", "https://api.github.com/users/" + owner + "/orgs"},
+            {"repos_url", "https://api.github.com/users/" + owner + "/repos"},
+            {"events_url", "https://api.github.com/users/" + owner + "/events{/privacy}"},
+            {"received_events_url", "https://api.github.com/users/" + owner + "/received_events"},
+            {"type", "User"},
+            {"site_admin", false}
+        }},
+        {"html_url", "https://github.com/" + full_name},
+        {"description", index % 5 == 0 ? nlohmann::json(nullptr)
+                                       : nlohmann::json("Synthetic \"fixture\" repository #" + std::to_string(index))},
+        {"fork", false},
+        {"url", api},
+        {"forks_url", api + "/forks"},
+        {"keys_url", api + "/keys{/key_id}"},
+        {"collaborators_url", api + "/collaborators{/collaborator}"},
+        {"teams_url", api + "/teams"},
+        {"hooks_url", api + "/hooks"},
+        {"issue_events_url", api + "/issues/events{/number}"},
+        {"events_url", api + "/events"},
+        {"assignees_url", api + "/assignees{/user}"},
+        {"branches_url", api + "/branches{/branch}"},
+        {"tags_url", api + "/tags"},
+        {"blobs_url", api + "/git/blobs{/sha}"},
+        {"git_tags_url", api + "/git/tags{/sha}"},
+        {"git_refs_url", api + "/git/refs{/sha}"},
+        {"trees_url", api + "/git/trees{/sha}"},
+        {"statuses_url", api + "/statuses/{sha}"},
+        {"languages_url", api + "/languages"},
+        {"stargazers_url", api + "/stargazers"},
+        {"contributors_url", api + "/contributors"},
+        {"subscribers_url", api + "/subscribers"},
+        {"subscription_url", api + "/subscription"},
+        {"commits_url", api + "/commits{/sha}"},
+        {"git_commits_url", api + "/git/commits{/sha}"},
+        {"comments_url", api + "/comments{/number}"},
+        {"issue_comment_url", api + "/issues/comments{/number}"},
+        {"contents_url", api + "/contents/{+path}"},
+        {"compare_url", api + "/compare/{base}...{head}"},
+        {"merges_url", api + "/merges"},
+        {"archive_url", api + "/{archive_format}{/ref}"},
+        {"downloads_url", api + "/downloads"},
+        {"issues_url", api + "/issues{/number}"},
+        {"pulls_url", api + "/pulls{/number}"},
+        {"milestones_url", api + "/milestones{/number}"},
+        {"notifications_url", api + "/notifications{?since,all,participating}"},
+        {"labels_url", api + "/labels{/name}"},
+        {"releases_url", api + "/releases{/id}"},
+        {"deployments_url", api + "/deployments"},
+        {"created_at", created_at},
+        {"updated_at", pushed_at},
+        {"pushed_at", pushed_at},
+        {"git_url", "git://github.com/" + full_name + ".git"},
+        {"ssh_url", "git@github.com:" + full_name + ".git"},
+        {"clone_url", "https://github.com/" + full_name + ".git"},
+        {"svn_url", "https://github.com/" + full_name},
+        {"homepage", nullptr},
+        {"size", 1024 + index % 4096},
+        {"stargazers_count", syntheticStars(index)},
+        {"watchers_count", syntheticStars(index)},
+        {"language", languages[index % 5]},
+        {"has_issues", true},
+        {"has_projects", true},
+        {"has_downloads", true},
+        {"has_wiki", true},
+        {"has_pages", false},
+        {"has_discussions", false},
+        {"forks_count", index % 1000},
+        {"mirror_url", nullptr},
+        {"archived", false},
+        {"disabled", false},
+        {"open_issues_count", index % 300},
+        {"allow_forking", true},
+        {"is_template", false},
+        {"web_commit_signoff_required", false},
+        {"topics", {"cpp", "search", "fixture"}},
+        {"visibility", "public"},
+        {"forks", index % 1000},
+        {"open_issues", index % 300},
+        {"watchers", syntheticStars(index)},
+        {"default_branch", "main"},
+        {"score", 1.0}
+    };
+    if (index % 7 == 6) {
+        item["license"] = nullptr;
+    } else {
+        const char* spdx = licenses[index % 5];
+        item["license"] = {
+            {"key", std::string(spdx) == "NOASSERTION" ? "other" : spdx},
+            {"name", spdx},
+            {"spdx_id", spdx},
+            {"url", nullptr},
+            {"node_id", "MDc6TGljZW5zZTA="}
+        };
+    }
+    return item;
+}
+
+// synthetic items [first, last) a query matches
+struct ItemRange {
+    long first = 0;
+    long last = 0;
+    long size() const { return std::max(0L, last - first); }
+};
+
+// one end of a qualifier range: a number, or a YYYY-MM-DD date as seconds
+static bool parseBound(const std::string& text, bool date, long long& value) {
+    if (date) {
+        std::tm parts{};
+        std::istringstream stream(text);
+        stream >> std::get_time(&parts, "%Y-%m-%d");
+        if (stream.fail()) return false;
+        value = static_cast<long long>(timegm(&parts));
+        return true;
+    }
+    try {
+        size_t used = 0;
+        value = std::stoll(text, &used);
+        return used == text.size();
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+// [lo, hi] of a stars: or created: value (>=N, >N, <=N, <N, A..B with *, N);
+// a date's upper bound takes in its whole day
+static bool parseRange(const std::string& value, bool date, long long& lo, long long& hi) {
+    const long long day_end = date ? 86399 : 0;
+    long long bound;
+    const size_t dots = value.find("..");
+    if (dots != std::string::npos) {
+        const std::string from = value.substr(0, dots), to = value.substr(dots + 2);
+        if (from != "*") {
+            if (!parseBound(from, date, bound)) return false;
+            lo = std::max(lo, bound);
+        }
+        if (to != "*") {
+            if (!parseBound(to, date, bound)) return false;
+            hi = std::min(hi, bound + day_end);
+        }
+        return true;
+    }
+    const size_t op = value.rfind(">=", 0) == 0 || value.rfind("<=", 0) == 0 ? 2 : value.find_first_of("<>") == 0 ? 1 : 0;
+    if (!parseBound(value.substr(op), date, bound)) return false;
+    const std::string comparison = value.substr(0, op);
+    const long long step = date ? 86400 : 1;
+    if (comparison == ">=") lo = std::max(lo, bound);
+    else if (comparison == ">") lo = std::max(lo, bound + step);
+    else if (comparison == "<=") hi = std::min(hi, bound + day_end);
+    else if (comparison == "<") hi = std::min(hi, bound - 1);
+    else {
+        lo = std::max(lo, bound);
+        hi = std::min(hi, bound + day_end);
+    }
+    return true;
+}
+
+// first index in [0, total) where a monotonic predicate turns true, total if it never does
+template <typename Predicate>
+static long firstIndex(long total, Predicate holds) {
+    long lo = 0, hi = total;
+    while (lo < hi) {
+        const long mid = lo + (hi - lo) / 2;
+        if (holds(mid)) hi = mid;
+        else lo = mid + 1;
+    }
+    return lo;
+}
+
+static ItemRange matchingItems(const MockOptions& options, const std::string& q) {
+    const long long none = std::numeric_limits<long long>::max();
+    long long stars_lo = 0, stars_hi = none, created_lo = 0, created_hi = none;
+    std::istringstream words(q);
+    std::string word;
+    while (words >> word) {
+        if (word.rfind("stars:", 0) == 0) parseRange(word.substr(6), false, stars_lo, stars_hi);
+        else if (word.rfind("created:", 0) == 0) parseRange(word.substr(8), true, created_lo, created_hi);
+    }
+    ItemRange range;
+    range.first = std::max(firstIndex(options.total, [&](long i) { return syntheticStars(i) <= stars_hi; }),
+                           firstIndex(options.total, [&](long i) { return syntheticCreated(i) >= created_lo; }));
+    range.last = std::min(firstIndex(options.total, [&](long i) { return syntheticStars(i) < stars_lo; }),
+                          firstIndex(options.total, [&](long i) { return syntheticCreated(i) > created_hi; }));
+    return range;
+}
+
+static std::string fixtureBody(const MockOptions& options, const ItemRange& items, long page, long per_page) {
+    if (!options.fixtures.empty()) {
+        std::ifstream file(options.fixtures + "/page-" + std::to_string(page) + ".json", std::ios::binary);
+        if (file) {
+            std::ostringstream contents;
+            contents << file.rdbuf();
+            return contents.str();
+        }
+        return "{\"total_count\":0,\"incomplete_results\":false,\"items\":[]}";
+    }
+
+    // like GitHub, only the first 1000 results of a query can be paged to
+    const long reachable = std::min(items.size(), 1000L);
+    nlohmann::json body = {
+        {"total_count", items.size()},
+        {"incomplete_results", false},
+        {"items", nlohmann::json::array()}
+    };
+    for (long i = (page - 1) * per_page; i < std::min(reachable, page * per_page); ++i) {
+        body["items"].push_back(syntheticItem(items.first + i));
+    }
+    return body.dump();
+}
+
+static std::string etagFor(const std::string& body) {
+    std::ostringstream etag;
+    etag << "W/\"" << std::hex << std::hash<std::string>{}(body) << "\"";
+    return etag.str();
+}
+
+static std::string linkHeader(const HttpRequest& request, long page, long last_page) {
+    std::string base = "<http://" + (request.headers.count("host") ? request.headers.at("host") : "localhost") +
+                       request.path + "?";
+    for (const auto& param : request.query) {
+        if (param.first == "page") continue;
+        // the query was decoded on the way in; the targets are re-encoded, as GitHub's are
+        base += urlEncode(param.first) + "=" + urlEncode(param.second) + "&";
+    }
+    std::string link;
+    auto add = [&](long target, const char* rel) {
+        if (!link.empty()) link += ", ";
+        link += base + "page=" + std::to_string(target) + ">; rel=\"" + rel + "\"";
+    };
+    if (page > 1) add(page - 1, "prev");
+    if (page < last_page) add(page + 1, "next");
+    if (last_page > 0) add(last_page, "last");
+    if (page > 1) add(1, "first");
+    return link;
+}
+
+static HttpResponse handle(const MockOptions& options, RateWindow& rate_window, const HttpRequest& request) {
+    HttpResponse response;
+    response.headers.emplace_back("Content-Type", "application/json; charset=utf-8");
+
+    thread_local std::mt19937 rng{std::random_device{}()};
+    int delay = options.latency_ms;
+    if (options.jitter_ms > 0) {
+        delay += std::uniform_int_distribution<int>(-options.jitter_ms, options.jitter_ms)(rng);
+    }
+    if (delay > 0) std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+
+    if (request.method != "GET" || request.path != "/search/repositories") {
+        response.status = 404;
+        response.body = "{\"message\":\"Not Found\",\"documentation_url\":\"https://docs.github.com/rest\"}";
+        return response;
+    }
+
+    const long per_page = std::clamp(queryLong(request, "per_page", 30), 1L, 100L);
+    const long page = std::max(1L, queryLong(request, "page", 1));
+    const auto q = request.query.find("q");
+    const ItemRange items = matchingItems(options, q == request.query.end() ? "" : q->second);
+    std::string body = fixtureBody(options, items, page, per_page);
+
+    // a 304 is answered before the rate limit, which only full responses draw on
+    const std::string etag = etagFor(body);
+    auto if_none_match = request.headers.find("if-none-match");
+    if (if_none_match != request.headers.end() && if_none_match->second == etag) {
+        if (options.rate_limit > 0) rate_window.report(response);
+        response.headers.emplace_back("ETag", etag);
+        response.status = 304;
+        return response;
+    }
+    if (options.rate_limit > 0 && !rate_window.take(response)) {
+        response.status = 403;
+        response.body = "{\"message\":\"API rate limit exceeded\",\"documentation_url\":"
+                        "\"https://docs.github.com/rest/overview/resources-in-the-rest-api#rate-limiting\"}";
+        return response;
+    }
+    if (options.error_rate > 0 && std::uniform_real_distribution<double>(0.0, 1.0)(rng) < options.error_rate) {
+        response.status = options.error_code;
+        response.body = "{\"message\":\"Injected failure\"}";
+        return response;
+    }
+
+    response.body = std::move(body);
+
+    const long reachable = options.fixtures.empty() ? std::min(items.size(), 1000L) : 0;
+    const long last_page = reachable > 0 ? (reachable + per_page - 1) / per_page : 0;
+    std::string link = linkHeader(request, page, last_page);
+    if (!link.empty()) response.headers.emplace_back("Link", link);
+    response.headers.emplace_back("ETag", etag);
+    return response;
+}
+
+static const char* reasonPhrase(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 304: return "Not Modified";
+        case 403: return "Forbidden";
+        case 404: return "Not Found";
+        case 422: return "Unprocessable Entity";
+        case 429: return "Too Many Requests";
+        case 500: return "Internal Server Error";
+        case 502: return "Bad Gateway";
+        case 503: return "Service Unavailable";
+        case 504: return "Gateway Timeout";
+        default: return "Status";
+    }
+}
+
+static bool sendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// keep-alive loop for one client connection
+static void serveConnection(int fd, const MockOptions& options, RateWindow& rate_window) {
+    std::string buffer;
+    char chunk[8192];
+    for (;;) {
+        size_t head_end;
+        while ((head_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+            ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                close(fd);
+                return;
+            }
+            buffer.append(chunk, static_cast<size_t>(n));
+        }
+
+        HttpRequest request;
+        const bool parsed = parseRequest(buffer.substr(0, head_end), request);
+        buffer.erase(0, head_end + 4);
+        HttpResponse response;
+        if (parsed) {
+            // this thread is detached: an exception escaping it would end the whole server
+            try {
+                response = handle(options, rate_window, request);
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << request.method << " " << request.path << ": " << e.what() << "\n";
+                response = HttpResponse();
+                response.status = 500;
+            }
+        } else {
+            response.status = 400;
+        }
+
+        const bool close_after = !parsed || (request.headers.count("connection") &&
+                                             request.headers.at("connection") == "close");
+        std::string out = "HTTP/1.1 " + std::to_string(response.status) + " " + reasonPhrase(response.status) + "\r\n";
+        for (const auto& header : response.headers) {
+            out += header.first + ": " + header.second + "\r\n";
+        }
+        out += "Content-Length: " + std::to_string(response.body.size()) + "\r\n";
+        if (close_after) out += "Connection: close\r\n";
+        out += "\r\n";
+        out += response.body;
+        if (!sendAll(fd, out) || close_after) {
+            close(fd);
+            return;
+        }
+    }
+}
+
+static void printUsage() {
+    std::cerr << "Usage: github-search-mock [--port N] [--fixtures DIR] [--total N] [--latency MS] [--jitter MS]\n"
+              << "                          [--rate-limit N] [--window SECONDS] [--error-rate P] [--error-code CODE]\n";
+}
+
+int main(int argc, char* argv[]) {
+    MockOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string { return i + 1 < argc ? argv[++i] : ""; };
+        try {
+            if (arg == "--port") options.port = std::stoi(next());
+            else if (arg == "--fixtures") options.fixtures = next();
+            else if (arg == "--total") options.total = std::stol(next());
+            else if (arg == "--latency") options.latency_ms = std::stoi(next());
+            else if (arg == "--jitter") options.jitter_ms = std::stoi(next());
+            else if (arg == "--rate-limit") options.rate_limit = std::stol(next());
+            else if (arg == "--window") options.window_s = std::max(1L, std::stol(next()));
+            else if (arg == "--error-rate") options.error_rate = std::stod(next());
+            else if (arg == "--error-code") options.error_code = std::stoi(next());
+            else {
+                printUsage();
+                return arg == "-h" || arg == "--help" ? 0 : 1;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Error: Invalid value for " << arg << "\n";
+            return 1;
+        }
+    }
+
+    int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        std::cerr << "Error: socket() failed.\n";
+        return 1;
+    }
+    int yes = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<uint16_t>(options.port));
+    if (bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(listen_fd, 512) < 0) {
+        std::cerr << "Error: Could not listen on 127.0.0.1:" << options.port << "\n";
+        close(listen_fd);
+        return 1;
+    }
+    std::signal(SIGPIPE, SIG_IGN);
+    std::cout << "github-search-mock listening on http://127.0.0.1:" << options.port << std::endl;
+
+    RateWindow rate_window(options.rate_limit, options.window_s);
+    for (;;) {
+        int client = accept(listen_fd, nullptr, nullptr);
+        if (client < 0) continue;
+        setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+        std::thread(serveConnection, client, std::cref(options), std::ref(rate_window)).detach();
+    }
+}
@@ -0,0 +1,54 @@
+#include "page_arena.h"
+
+static thread_local std::pmr::memory_resource* current_resource = nullptr;
+
+PageArena::PageArena(size_t initial_bytes)
+    : block(new std::byte[initial_bytes == 0 ? 1 : initial_bytes]), block_size(initial_bytes == 0 ? 1 : initial_bytes) {
+  arena.emplace(block.get(), block_size, &upstream);
+}
+
+void PageArena::reset() {
+  ++pages;
+  arena.reset();  // hands what it got from upstream back
+  if (upstream.bytes > 0) {
+      // this page didn't fit: next time start with room for all of it
+      size_t grown = block_size;
+      while (grown < block_size + upstream.bytes) grown *= 2;
+      block.reset(new std::byte[grown]);
+      block_size = grown;
+      upstream_total += upstream.allocations;
+      upstream.allocations = 0;
+      upstream.bytes = 0;
+  }
+  arena.emplace(block.get(), block_size, &upstream);
+}
+
+PageArena::Stats PageArena::stats() const {
+  return Stats{pages, upstream_total + upstream.allocations, block_size};
+}
+
+PageArena::Scope::Scope(std::pmr::memory_resource* resource) : previous(current_resource) {
+  current_resource = resource;
+}
+
+PageArena::Scope::~Scope() {
+  current_resource = previous;
+}
+
+std::pmr::memory_resource* PageArena::current() {
+  return current_resource ? current_resource : std::pmr::get_default_resource();
+}
+
+void* PageArena::CountingResource::do_allocate(size_t size, size_t alignment) {
+  ++allocations;
+  bytes += size;
+  return std::pmr::new_delete_resource()->allocate(size, alignment);
+}
+
+void PageArena::CountingResource::do_deallocate(void* p, size_t size, size_t alignment) {
+  std::pmr::new_delete_resource()->deallocate(p, size, alignment);
+}
+
+bool PageArena::CountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+  return this == &other;
+}
@@ -0,0 +1,73 @@
+#ifndef PAGE_ARENA_H
+#define PAGE_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+// Bump allocator for everything parsing one page creates: the json.hpp DOM
+// (see arena_json.h), the ProjectInfo strings and the vector holding them.
+// Nothing is freed individually; reset() drops the whole page at once and
+// starts over in the same block. When a page outgrew the block, reset()
+// replaces it with one big enough, so a long crawl settles at no heap
+// allocations per page. Not thread-safe; one arena per thread.
+class PageArena {
+public:
+    struct Stats {
+        unsigned long long pages;                 // resets so far
+        unsigned long long upstream_allocations;  // times the arena went to the heap
+        size_t block_size;                        // current size of the retained block
+    };
+
+    explicit PageArena(size_t initial_bytes = 256 * 1024);
+    PageArena(const PageArena&) = delete;
+    PageArena& operator=(const PageArena&) = delete;
+
+    std::pmr::memory_resource* resource() { return &*arena; }
+
+    // Release everything allocated since the last reset. Whatever lives in the
+    // arena (a std::pmr::vector<ProjectInfo> using it, say) must be gone first.
+    void reset();
+
+    Stats stats() const;
+
+    // While alive, ArenaAllocator on this thread allocates from resource.
+    // json.hpp default-constructs its allocators, so this is how a DOM gets
+    // into an arena. Scopes nest.
+    class Scope {
+    public:
+        explicit Scope(std::pmr::memory_resource* resource);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        std::pmr::memory_resource* previous;
+    };
+
+    // Resource of the innermost Scope on this thread, the default resource outside any.
+    static std::pmr::memory_resource* current();
+
+private:
+    // heap behind the arena, counting how much it had to hand out
+    class CountingResource : public std::pmr::memory_resource {
+    public:
+        unsigned long long allocations = 0;
+        size_t bytes = 0;
+
+    private:
+        void* do_allocate(size_t size, size_t alignment) override;
+        void do_deallocate(void* p, size_t size, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+    };
+
+    CountingResource upstream;
+    std::unique_ptr<std::byte[]> block;
+    size_t block_size;
+    std::optional<std::pmr::monotonic_buffer_resource> arena;
+    unsigned long long pages = 0;
+    unsigned long long upstream_total = 0;
+};
+
+#endif
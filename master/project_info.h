@@ -0,0 +1,98 @@
+#ifndef PROJECT_INFO_H
+#define PROJECT_INFO_H
+
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "iso_time.h"
+#include "spdx_license.h"
+
+// Where the owner ends in a full_name ("owner/repo"); 0 when there's no slash.
+inline std::uint16_t ownerLength(std::string_view full_name) {
+    const size_t slash = full_name.find('/');
+    return slash == std::string_view::npos || slash > UINT16_MAX ? 0 : static_cast<std::uint16_t>(slash);
+}
+
+// Allocator-aware, so a page's results can live in a PageArena: a
+// std::pmr::vector<ProjectInfo> hands its resource down to every string.
+// Copies go back to the default (heap) resource, moves keep the allocator.
+// Timestamps and licenses are kept parsed, as integers; pushedAtText() and
+// licenseName() give them back for display. The item's id is always
+// extracted, whatever --fields asks for, since results are told apart by it.
+struct ProjectInfo {
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+    ProjectInfo() = default;
+    explicit ProjectInfo(const allocator_type& allocator)
+        : name(allocator), html_url(allocator), description(allocator), extra_fields(allocator) {}
+    ProjectInfo(const ProjectInfo& other, const allocator_type& allocator)
+        : name(other.name, allocator), html_url(other.html_url, allocator),
+          description(other.description, allocator), id(other.id), pushed_at(other.pushed_at),
+          stargazers_count(other.stargazers_count), owner_length(other.owner_length), license(other.license),
+          extra_fields(other.extra_fields, allocator) {}
+    ProjectInfo(ProjectInfo&& other, const allocator_type& allocator)
+        : name(std::move(other.name), allocator), html_url(std::move(other.html_url), allocator),
+          description(std::move(other.description), allocator), id(other.id), pushed_at(other.pushed_at),
+          stargazers_count(other.stargazers_count), owner_length(other.owner_length), license(other.license),
+          extra_fields(std::move(other.extra_fields), allocator) {}
+    ProjectInfo(const ProjectInfo&) = default;
+    ProjectInfo(ProjectInfo&&) = default;
+    ProjectInfo& operator=(const ProjectInfo&) = default;
+    ProjectInfo& operator=(ProjectInfo&&) = default;
+
+    allocator_type get_allocator() const { return name.get_allocator(); }
+
+    // Set name and where its owner ends; assign name only through this.
+    void setName(std::string_view full_name) {
+        name = full_name;
+        owner_length = ownerLength(full_name);
+    }
+    std::string_view owner() const { return std::string_view(name).substr(0, owner_length); }
+    std::string_view repo() const { return std::string_view(name).substr(owner_length ? owner_length + 1u : 0u); }
+
+    std::string pushedAtText() const { return pushed_at == NO_TIMESTAMP ? "N/A" : formatIsoTimestamp(pushed_at); }
+    std::string_view licenseName() const { return spdxName(license); }
+
+    std::pmr::string name;                   // full_name, "owner/repo"
+    std::pmr::string html_url;
+    std::pmr::string description;
+    std::int64_t id = 0;                     // the repository's numeric id, 0 when the item had none
+    std::int64_t pushed_at = NO_TIMESTAMP;   // epoch seconds
+    int stargazers_count = 0;
+    std::uint16_t owner_length = 0;          // name[0, owner_length) is the owner
+    SpdxLicense license = SpdxLicense::Unknown;
+    // fields requested with --fields beyond the ones above, as (path, value)
+    std::pmr::vector<std::pair<std::pmr::string, std::pmr::string>> extra_fields;
+};
+
+// ProjectInfo without the copies: every field points into storage owned by
+// the SearchPage it came from (the response body, decoded in place), or at a
+// string literal for missing values. Only valid while that page is alive.
+// The parsed fields are the same as ProjectInfo's.
+struct ProjectInfoView {
+    void setName(std::string_view full_name) {
+        name = full_name;
+        owner_length = ownerLength(full_name);
+    }
+    std::string_view owner() const { return name.substr(0, owner_length); }
+    std::string_view repo() const { return name.substr(owner_length ? owner_length + 1u : 0u); }
+
+    std::string pushedAtText() const { return pushed_at == NO_TIMESTAMP ? "N/A" : formatIsoTimestamp(pushed_at); }
+    std::string_view licenseName() const { return spdxName(license); }
+
+    std::string_view name;
+    std::string_view html_url;
+    std::string_view description;
+    std::int64_t id = 0;
+    std::int64_t pushed_at = NO_TIMESTAMP;
+    int stargazers_count = 0;
+    std::uint16_t owner_length = 0;
+    SpdxLicense license = SpdxLicense::Unknown;
+    // values of the --fields paths beyond the ones above, in extra_fields order
+    std::vector<std::string_view> extra_values;
+};
+
+#endif
@@ -0,0 +1,154 @@
+#include "project_table.h"
+#include <algorithm>
+#include "search_fields.h"
+#include "search_page.h"
+
+Selection::Selection(size_t rows, bool all) : bits((rows + 63) / 64, all ? ~uint64_t(0) : 0), row_count(rows) {
+  if (all && rows % 64) bits.back() = (uint64_t(1) << (rows % 64)) - 1;
+}
+
+size_t Selection::count() const {
+  size_t total = 0;
+  for (uint64_t word : bits) {
+#if defined(__GNUC__)
+      total += static_cast<size_t>(__builtin_popcountll(word));
+#else
+      for (; word; word &= word - 1) ++total;
+#endif
+  }
+  return total;
+}
+
+void ProjectTable::StringColumn::push(std::string_view value) {
+  bytes.append(value.data(), value.size());
+  ends.push_back(bytes.size());
+}
+
+std::string_view ProjectTable::StringColumn::at(size_t index) const {
+  const size_t begin = index ? ends[index - 1] : 0;
+  return std::string_view(bytes).substr(begin, ends[index] - begin);
+}
+
+void ProjectTable::StringColumn::clear() {
+  bytes.clear();
+  ends.clear();
+}
+
+ProjectTable::ProjectTable(const SearchFields& fields, StringInterner& interner) : interner(&interner) {
+  for (const std::string& path : fields.extraPaths()) {
+      extras.emplace_back();
+      extras.back().path = path;
+      extras.back().interned = SearchFields::repeats(path);
+  }
+}
+
+void ProjectTable::clear() {
+  star_column.clear();
+  pushed_column.clear();
+  license_column.clear();
+  id_column.clear();
+  owner_column.clear();
+  names.clear();
+  urls.clear();
+  descriptions.clear();
+  for (ExtraColumn& column : extras) {
+      column.text.clear();
+      column.values.clear();
+  }
+}
+
+void ProjectTable::reserve(size_t rows) {
+  star_column.reserve(rows);
+  pushed_column.reserve(rows);
+  license_column.reserve(rows);
+  id_column.reserve(rows);
+  owner_column.reserve(rows);
+  names.ends.reserve(rows);
+  urls.ends.reserve(rows);
+  descriptions.ends.reserve(rows);
+  for (ExtraColumn& column : extras) {
+      if (column.interned) {
+          column.values.reserve(rows);
+      } else {
+          column.text.ends.reserve(rows);
+      }
+  }
+}
+
+void ProjectTable::append(const ProjectInfoView& view) {
+  if (extras.size() < view.extra_values.size()) {
+      // a column that appears late is empty for the rows before it
+      const size_t first_new = extras.size();
+      extras.resize(view.extra_values.size());
+      for (size_t column = first_new; column < extras.size(); ++column) extras[column].text.ends.assign(size(), 0);
+  }
+  for (size_t column = 0; column < extras.size(); ++column) {
+      const std::string_view value = column < view.extra_values.size() ? view.extra_values[column] : std::string_view();
+      if (extras[column].interned) {
+          extras[column].values.push_back(interner->intern(value));
+      } else {
+          extras[column].text.push(value);
+      }
+  }
+  names.push(view.name);
+  urls.push(view.html_url);
+  descriptions.push(view.description);
+  owner_column.push_back(view.owner_length);
+  license_column.push_back(static_cast<uint8_t>(view.license));
+  id_column.push_back(view.id);
+  pushed_column.push_back(view.pushed_at);
+  star_column.push_back(view.stargazers_count);
+}
+
+void ProjectTable::append(const ProjectInfo& project) {
+  ProjectInfoView view;
+  view.name = project.name;
+  view.html_url = project.html_url;
+  view.description = project.description;
+  view.id = project.id;
+  view.pushed_at = project.pushed_at;
+  view.stargazers_count = project.stargazers_count;
+  view.owner_length = project.owner_length;
+  view.license = project.license;
+  view.extra_values.reserve(project.extra_fields.size());
+  for (const auto& extra : project.extra_fields) view.extra_values.push_back(extra.second);
+  append(view);
+}
+
+void ProjectTable::append(const SearchPage& page) {
+  for (const ProjectInfoView& view : page.items()) append(view);
+}
+
+void ProjectTable::append(const std::vector<ProjectInfo>& projects) {
+  for (const ProjectInfo& project : projects) append(project);
+}
+
+ProjectInfoView ProjectTable::row(size_t index) const {
+  ProjectInfoView view;
+  view.name = names.at(index);
+  view.html_url = urls.at(index);
+  view.description = descriptions.at(index);
+  view.id = id_column[index];
+  view.pushed_at = pushed_column[index];
+  view.stargazers_count = star_column[index];
+  view.owner_length = owner_column[index];
+  view.license = static_cast<SpdxLicense>(license_column[index]);
+  view.extra_values.reserve(extras.size());
+  for (const ExtraColumn& column : extras) view.extra_values.push_back(column.at(index));
+  return view;
+}
+
+const std::vector<std::string_view>* ProjectTable::internedColumn(const std::string& path) const {
+  for (const ExtraColumn& column : extras) {
+      if (column.interned && column.path == path) return &column.values;
+  }
+  return nullptr;
+}
+
+void ProjectTable::sortRows(std::vector<size_t>& rows, SortKey key) const {
+  if (key == SortKey::Stars) {
+      std::stable_sort(rows.begin(), rows.end(), [this](size_t a, size_t b) { return star_column[a] > star_column[b]; });
+  } else {
+      std::stable_sort(rows.begin(), rows.end(), [this](size_t a, size_t b) { return pushed_column[a] > pushed_column[b]; });
+  }
+}
@@ -0,0 +1,129 @@
+#ifndef PROJECT_TABLE_H
+#define PROJECT_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "project_info.h"
+#include "string_interner.h"
+
+class SearchFields;
+class SearchPage;
+
+// One bit per row of a ProjectTable, 64 rows to a word; what a TableFilter
+// produces. Bits past the last row are always clear.
+class Selection {
+public:
+    Selection() = default;
+    // Every row selected, or none.
+    explicit Selection(size_t rows, bool all = true);
+
+    size_t rows() const { return row_count; }
+    size_t count() const;
+    bool test(size_t row) const { return (bits[row / 64] >> (row % 64)) & 1; }
+
+    std::vector<uint64_t>& words() { return bits; }
+    const std::vector<uint64_t>& words() const { return bits; }
+
+    // Call f(row) for each selected row, in order.
+    template <typename F>
+    void forEach(F&& f) const {
+        for (size_t w = 0; w < bits.size(); ++w) {
+            for (uint64_t word = bits[w]; word; word &= word - 1) {
+                f(w * 64 + static_cast<size_t>(lowestBit(word)));
+            }
+        }
+    }
+
+private:
+    static int lowestBit(uint64_t word) {
+#if defined(__GNUC__)
+        return __builtin_ctzll(word);
+#else
+        int n = 0;
+        while (!(word & 1)) {
+            word >>= 1;
+            ++n;
+        }
+        return n;
+#endif
+    }
+
+    std::vector<uint64_t> bits;
+    size_t row_count = 0;
+};
+
+// Search results stored column by column: the numbers a filter looks at sit
+// in plain contiguous arrays (stars, pushed_at epoch seconds, license ids,
+// repository ids),
+// and the strings are appended to one blob per column, addressed by end
+// offsets. Filling it copies each string once and allocates only when a
+// column grows. row() hands a row back as a ProjectInfoView into the blobs,
+// valid until the table is appended to or cleared. Extra --fields values
+// whose path SearchFields::repeats() are interned rather than copied, so a
+// login or language seen a thousand times is stored once and compared by
+// pointer.
+class ProjectTable {
+public:
+    ProjectTable() = default;
+    // Columns for the extra paths of fields, interning into interner.
+    explicit ProjectTable(const SearchFields& fields, StringInterner& interner = StringInterner::global());
+
+    size_t size() const { return star_column.size(); }
+    bool empty() const { return star_column.empty(); }
+    void clear();
+    void reserve(size_t rows);
+
+    void append(const ProjectInfoView& view);
+    void append(const ProjectInfo& project);
+    void append(const SearchPage& page);
+    void append(const std::vector<ProjectInfo>& projects);
+
+    ProjectInfoView row(size_t index) const;
+
+    // Reorder row numbers by a column, largest first; ties keep their order.
+    enum class SortKey { Stars, Pushed };
+    void sortRows(std::vector<size_t>& rows, SortKey key) const;
+
+    const std::vector<int32_t>& stars() const { return star_column; }
+    const std::vector<int64_t>& pushedAt() const { return pushed_column; }
+    const std::vector<uint8_t>& licenses() const { return license_column; }
+    const std::vector<int64_t>& ids() const { return id_column; }
+    std::string_view name(size_t index) const { return names.at(index); }
+    // Interned values of an extra path, nullptr unless the table interns it.
+    const std::vector<std::string_view>* internedColumn(const std::string& path) const;
+
+private:
+    struct StringColumn {
+        std::string bytes;
+        std::vector<size_t> ends;  // row i is bytes[ends[i - 1], ends[i])
+
+        void push(std::string_view value);
+        std::string_view at(size_t index) const;
+        void clear();
+    };
+
+    struct ExtraColumn {
+        std::string path;
+        bool interned = false;
+        StringColumn text;                    // unless interned
+        std::vector<std::string_view> values;  // if interned
+
+        std::string_view at(size_t index) const { return interned ? values[index] : text.at(index); }
+    };
+
+    std::vector<int32_t> star_column;
+    std::vector<int64_t> pushed_column;
+    std::vector<uint8_t> license_column;
+    std::vector<int64_t> id_column;
+    std::vector<uint16_t> owner_column;
+    StringColumn names;
+    StringColumn urls;
+    StringColumn descriptions;
+    std::vector<ExtraColumn> extras;  // --fields values, one column per extra path
+    StringInterner* interner = &StringInterner::global();
+};
+
+#endif
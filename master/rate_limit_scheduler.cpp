@@ -0,0 +1,140 @@
+#include "rate_limit_scheduler.h"
+#include <algorithm>
+#include <thread>
+
+RateLimitScheduler::RateLimitScheduler(int burst) : burst(std::max(1, burst)) {}
+
+std::shared_ptr<RateLimitScheduler> RateLimitScheduler::forToken(const std::string& token) {
+  static std::mutex registry_mutex;
+  static std::map<std::string, std::shared_ptr<RateLimitScheduler>> registry;
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  std::shared_ptr<RateLimitScheduler>& scheduler = registry[token];
+  if (!scheduler) scheduler = std::make_shared<RateLimitScheduler>();
+  return scheduler;
+}
+
+RateLimitScheduler::Bucket& RateLimitScheduler::bucketFor(const std::string& resource) {
+  return buckets[resource];
+}
+
+std::string RateLimitScheduler::resourceForUrl(const std::string& url) {
+  return url.find("/search/") != std::string::npos ? "search" : "core";
+}
+
+RateLimitScheduler::Clock::duration RateLimitScheduler::reserve(const std::string& resource) {
+  std::lock_guard<std::mutex> lock(mutex);
+  Bucket& bucket = bucketFor(resource);
+  const Clock::time_point now = Clock::now();
+
+  auto hold = [&](Clock::duration wait) {
+      if (bucket.waiting_since == Clock::time_point{}) bucket.waiting_since = now;
+      return std::max<Clock::duration>(wait, std::chrono::milliseconds(1));
+  };
+  auto grant = [&]() {
+      ++counters.requests;
+      if (bucket.waiting_since != Clock::time_point{}) {
+          ++counters.delayed;
+          counters.waited += std::chrono::duration_cast<std::chrono::milliseconds>(now - bucket.waiting_since);
+          bucket.waiting_since = Clock::time_point{};
+      }
+      return Clock::duration::zero();
+  };
+
+  if (now < bucket.blocked_until) return hold(bucket.blocked_until - now);
+
+  Budget& budget = bucket.budget;
+  if (budget.remaining < 0 || budget.reset == 0) return grant();  // nothing learned yet
+
+  const std::time_t wall_now = std::time(nullptr);
+  if (budget.remaining <= 0) {
+      if (budget.reset > wall_now) {
+          // exhausted: nothing to pace, sit out the rest of the window
+          bucket.blocked_until = now + std::chrono::seconds(budget.reset - wall_now + 1);
+          return hold(bucket.blocked_until - now);
+      }
+      // the window rolled over since the last response, assume a full budget
+      budget.remaining = budget.limit > 0 ? budget.limit : 1;
+      budget.reset = 0;
+      return grant();
+  }
+
+  // spread what is left evenly over the rest of the window
+  const double window = static_cast<double>(std::max<std::time_t>(1, budget.reset - wall_now));
+  const double interval = window / static_cast<double>(budget.remaining);
+  const double elapsed = std::chrono::duration<double>(now - bucket.last_refill).count();
+  bucket.tokens = std::min<double>(burst, bucket.tokens + elapsed / interval);
+  bucket.last_refill = now;
+
+  if (bucket.tokens >= 1.0) {
+      bucket.tokens -= 1.0;
+      --budget.remaining;  // optimistic until the response reports the real count
+      return grant();
+  }
+  return hold(std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>((1.0 - bucket.tokens) * interval)));
+}
+
+void RateLimitScheduler::acquire(const std::string& resource) {
+  for (;;) {
+      Clock::duration wait = reserve(resource);
+      if (wait == Clock::duration::zero()) return;
+      std::this_thread::sleep_for(wait);
+  }
+}
+
+void RateLimitScheduler::update(const std::string& resource, const HttpHeaders& headers, long http_code) {
+  auto header_long = [&](const char* name, long& out) {
+      auto it = headers.find(name);
+      if (it == headers.end()) return false;
+      try {
+          out = std::stol(it->second);
+          return true;
+      } catch (const std::exception&) {
+          return false;
+      }
+  };
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto named = headers.find("x-ratelimit-resource");
+  Bucket& bucket = bucketFor(named != headers.end() && !named->second.empty() ? named->second : resource);
+  Budget& budget = bucket.budget;
+  const Clock::time_point now = Clock::now();
+
+  long limit = 0, remaining = 0, reset = 0;
+  if (header_long("x-ratelimit-limit", limit)) budget.limit = limit;
+  if (header_long("x-ratelimit-reset", reset) && header_long("x-ratelimit-remaining", remaining)) {
+      const bool first_report = budget.remaining < 0;
+      // responses of concurrent requests arrive out of order; within one window
+      // the smallest remaining count is the most recent
+      if (first_report || static_cast<std::time_t>(reset) != budget.reset) {
+          budget.remaining = remaining;
+          budget.reset = static_cast<std::time_t>(reset);
+      } else {
+          budget.remaining = std::min(budget.remaining, remaining);
+      }
+      if (first_report) {
+          bucket.tokens = 1.0;
+          bucket.last_refill = now;
+      }
+  }
+
+  long retry_after = 0;
+  const bool has_retry_after = header_long("retry-after", retry_after) && retry_after > 0;
+  if (has_retry_after) {
+      bucket.blocked_until = std::max(bucket.blocked_until, now + std::chrono::seconds(retry_after));
+  }
+  if ((http_code == 403 || http_code == 429) && (has_retry_after || budget.remaining == 0)) {
+      ++counters.rate_limited;
+  }
+}
+
+RateLimitScheduler::Budget RateLimitScheduler::budget(const std::string& resource) const {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = buckets.find(resource);
+  return it == buckets.end() ? Budget{} : it->second.budget;
+}
+
+RateLimitScheduler::Stats RateLimitScheduler::stats() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return counters;
+}
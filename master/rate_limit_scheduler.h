@@ -0,0 +1,77 @@
+#ifndef RATE_LIMIT_SCHEDULER_H
+#define RATE_LIMIT_SCHEDULER_H
+
+#include <chrono>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "http_headers.h"
+
+// Paces outgoing requests against GitHub's rate limits. Every response feeds
+// its X-RateLimit-* / Retry-After headers back in; before each request a token
+// bucket per resource ("search", "core", ...) is refilled at
+// remaining / seconds-until-reset, so the budget is spread over the whole
+// window instead of being burned in a burst and then stalling until reset.
+// Until a resource has reported its budget, requests are not held back.
+// Thread-safe.
+class RateLimitScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Budget {
+        long limit = -1;        // -1 until GitHub reported it
+        long remaining = -1;
+        std::time_t reset = 0;  // epoch seconds
+    };
+
+    struct Stats {
+        unsigned long long requests;
+        unsigned long long delayed;           // requests that had to wait
+        unsigned long long rate_limited;      // 403/429 responses caused by the rate limit
+        std::chrono::milliseconds waited;     // total time spent waiting
+    };
+
+    // burst: how many requests may go out back to back when budget has accumulated
+    explicit RateLimitScheduler(int burst = 3);
+
+    // Budgets belong to a token (the empty token is the unauthenticated per-IP
+    // budget), so every user of the same token in the process shares one scheduler.
+    static std::shared_ptr<RateLimitScheduler> forToken(const std::string& token);
+
+    // Take a token for one request if one is available and return zero,
+    // otherwise return how long to wait before asking again.
+    Clock::duration reserve(const std::string& resource);
+
+    // Blocking form of reserve().
+    void acquire(const std::string& resource);
+
+    // Learn the budget from a response. resource is used when the response
+    // doesn't name one in X-RateLimit-Resource.
+    void update(const std::string& resource, const HttpHeaders& headers, long http_code);
+
+    Budget budget(const std::string& resource) const;
+    Stats stats() const;
+
+    // "search" for the search endpoints, "core" for the rest of the REST API.
+    static std::string resourceForUrl(const std::string& url);
+
+private:
+    struct Bucket {
+        Budget budget;
+        double tokens = 0.0;
+        Clock::time_point last_refill{};
+        Clock::time_point blocked_until{};  // from Retry-After or an exhausted budget
+        Clock::time_point waiting_since{};  // first reserve() that had to be turned away
+    };
+
+    Bucket& bucketFor(const std::string& resource);
+
+    mutable std::mutex mutex;
+    int burst;
+    std::map<std::string, Bucket> buckets;
+    Stats counters{0, 0, 0, std::chrono::milliseconds(0)};
+};
+
+#endif
@@ -0,0 +1,156 @@
+#include "repo_id_set.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+static const char FILE_MAGIC[8] = {'G', 'H', 'S', 'I', 'D', 'S', '1', '\n'};
+static const size_t MIN_CAPACITY = 16;
+
+RepoIdSet::RepoIdSet(size_t expected) {
+  reserve(expected);
+}
+
+// multiplying by 2^64/phi spreads the sequential ids GitHub hands out over
+// the whole table; the top bits pick the slot
+size_t RepoIdSet::slotOf(std::uint64_t key) const {
+  return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> shift);
+}
+
+void RepoIdSet::rehash(size_t capacity) {
+  std::vector<std::uint64_t> old(capacity, 0);
+  old.swap(slots);
+  shift = 64;
+  for (size_t c = capacity; c > 1; c >>= 1) --shift;
+  const size_t mask = capacity - 1;
+  for (std::uint64_t key : old) {
+      if (!key) continue;
+      size_t slot = slotOf(key);
+      while (slots[slot]) slot = (slot + 1) & mask;
+      slots[slot] = key;
+  }
+}
+
+void RepoIdSet::reserve(size_t expected) {
+  size_t capacity = std::max(MIN_CAPACITY, slots.size());
+  while (capacity < expected * 2) capacity *= 2;
+  if (capacity != slots.size()) rehash(capacity);
+}
+
+void RepoIdSet::clear() {
+  std::fill(slots.begin(), slots.end(), 0);
+  count = 0;
+}
+
+bool RepoIdSet::insert(std::int64_t id) {
+  if (id == 0) return true;
+  if ((count + 1) * 2 > slots.size()) rehash(std::max(MIN_CAPACITY, slots.size() * 2));
+  const std::uint64_t key = static_cast<std::uint64_t>(id);
+  const size_t mask = slots.size() - 1;
+  for (size_t slot = slotOf(key);; slot = (slot + 1) & mask) {
+      if (slots[slot] == key) return false;
+      if (!slots[slot]) {
+          slots[slot] = key;
+          ++count;
+          return true;
+      }
+  }
+}
+
+bool RepoIdSet::contains(std::int64_t id) const {
+  if (id == 0 || slots.empty()) return false;
+  const std::uint64_t key = static_cast<std::uint64_t>(id);
+  const size_t mask = slots.size() - 1;
+  for (size_t slot = slotOf(key); slots[slot]; slot = (slot + 1) & mask) {
+      if (slots[slot] == key) return true;
+  }
+  return false;
+}
+
+// LEB128: seven bits a byte, low bits first, the top bit set on all but the last
+static void putVarint(std::string& out, std::uint64_t value) {
+  while (value >= 0x80) {
+      out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+static bool getVarint(const std::string& in, size_t& pos, std::uint64_t& value) {
+  value = 0;
+  for (int bits = 0; bits < 64 && pos < in.size(); bits += 7) {
+      const unsigned char byte = static_cast<unsigned char>(in[pos++]);
+      value |= static_cast<std::uint64_t>(byte & 0x7F) << bits;
+      if (!(byte & 0x80)) return true;
+  }
+  return false;
+}
+
+bool RepoIdSet::save(const std::string& path, std::string& error) const {
+  std::vector<std::uint64_t> ids;
+  ids.reserve(count);
+  for (std::uint64_t key : slots) {
+      if (key) ids.push_back(key);
+  }
+  std::sort(ids.begin(), ids.end());
+
+  std::string out(FILE_MAGIC, sizeof(FILE_MAGIC));
+  out.reserve(sizeof(FILE_MAGIC) + 10 + ids.size() * 3);
+  putVarint(out, ids.size());
+  std::uint64_t previous = 0;
+  for (std::uint64_t id : ids) {
+      putVarint(out, id - previous);
+      previous = id;
+  }
+
+  // written next to the old file and renamed over it, so a failed run never leaves half a file
+  const std::string temporary = path + ".tmp";
+  {
+      std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+      if (!file || !file.write(out.data(), static_cast<std::streamsize>(out.size())) || !file.flush()) {
+          error = "can't write " + temporary;
+          return false;
+      }
+  }
+  if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+      std::remove(temporary.c_str());
+      error = "can't replace " + path;
+      return false;
+  }
+  return true;
+}
+
+bool RepoIdSet::load(const std::string& path, std::string& error) {
+  std::error_code exists_error;
+  if (!std::filesystem::exists(path, exists_error) && !exists_error) return true;  // not there yet: nothing seen
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+      error = "can't read " + path;
+      return false;
+  }
+  const std::string in((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  if (in.size() < sizeof(FILE_MAGIC) || !std::equal(FILE_MAGIC, FILE_MAGIC + sizeof(FILE_MAGIC), in.begin())) {
+      error = path + " is not a repository id file";
+      return false;
+  }
+  size_t pos = sizeof(FILE_MAGIC);
+  std::uint64_t stored = 0;
+  // every id takes at least a byte, which bounds what a corrupt count can reserve
+  if (!getVarint(in, pos, stored) || stored > in.size() - pos) {
+      error = path + " is truncated";
+      return false;
+  }
+  reserve(count + static_cast<size_t>(stored));
+  std::uint64_t id = 0;
+  for (std::uint64_t i = 0; i < stored; ++i) {
+      std::uint64_t delta;
+      if (!getVarint(in, pos, delta) || (i > 0 && delta == 0)) {
+          error = path + " is corrupt";
+          return false;
+      }
+      id += delta;
+      insert(static_cast<std::int64_t>(id));
+  }
+  return true;
+}
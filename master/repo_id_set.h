@@ -0,0 +1,60 @@
+#ifndef REPO_ID_SET_H
+#define REPO_ID_SET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "project_info.h"
+
+// Repository ids already emitted, so results that turn up again (on a later
+// page after the ranking shifted, in a neighbouring shard, in an earlier run)
+// are dropped without sorting anything. Open addressing over a power-of-two
+// table of 64-bit keys with linear probing, kept at most half full; 0, which
+// no repository has, marks an empty slot. Not thread-safe.
+class RepoIdSet {
+public:
+    explicit RepoIdSet(size_t expected = 0);
+
+    // True when id is new (and now recorded). Id 0 means the item had none:
+    // it is never recorded and always reported as new.
+    bool insert(std::int64_t id);
+    bool contains(std::int64_t id) const;
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    // Room for expected ids without growing.
+    void reserve(size_t expected);
+    void clear();
+
+    // Move the projects whose id is new from page onto the end of out, in
+    // order; the number dropped as already seen.
+    template <typename Projects>
+    size_t appendNew(Projects& out, Projects& page) {
+        size_t dropped = 0;
+        for (ProjectInfo& project : page) {
+            if (insert(project.id)) {
+                out.push_back(std::move(project));
+            } else {
+                ++dropped;
+            }
+        }
+        return dropped;
+    }
+
+    // The ids, sorted, as a magic number, a count and varint deltas: a byte
+    // or two an id when they are close together, as a crawl's tend to be.
+    // load() adds a file's ids to the set; a missing file is an empty one,
+    // false and a message in error if it can't be read or isn't such a file.
+    bool save(const std::string& path, std::string& error) const;
+    bool load(const std::string& path, std::string& error);
+
+private:
+    size_t slotOf(std::uint64_t key) const;
+    void rehash(size_t capacity);
+
+    std::vector<std::uint64_t> slots;
+    size_t count = 0;
+    int shift = 64;  // 64 - log2(capacity), for Fibonacci hashing
+};
+
+#endif
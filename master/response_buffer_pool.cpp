@@ -0,0 +1,103 @@
+#include "response_buffer_pool.h"
+#include <algorithm>
+#include <cstdlib>
+
+// buffers beyond this are freed instead of pooled, one odd response shouldn't pin its memory
+static const size_t MAX_POOLED_CAPACITY = 16 * 1024 * 1024;
+
+ResponseBufferPool::ResponseBufferPool(size_t max_buffers) : max_buffers(max_buffers) {}
+
+std::shared_ptr<ResponseBufferPool> ResponseBufferPool::global() {
+  static std::shared_ptr<ResponseBufferPool> pool = std::make_shared<ResponseBufferPool>();
+  return pool;
+}
+
+std::string ResponseBufferPool::endpointKey(const std::string& url) {
+  size_t scheme = url.find("://");
+  size_t path_start = url.find('/', scheme == std::string::npos ? 0 : scheme + 3);
+  if (path_start == std::string::npos) return "/";
+  size_t query = url.find('?', path_start);
+  std::string key = url.substr(path_start, query == std::string::npos ? std::string::npos : query - path_start);
+  if (query == std::string::npos) return key;
+  // page size is what decides the body size of a search, the query itself hardly does
+  size_t per_page = url.find("per_page=", query);
+  if (per_page != std::string::npos && (url[per_page - 1] == '?' || url[per_page - 1] == '&')) {
+      size_t end = url.find('&', per_page);
+      key += "?" + url.substr(per_page, end == std::string::npos ? std::string::npos : end - per_page);
+  }
+  return key;
+}
+
+std::string ResponseBufferPool::acquire(const std::string& endpoint) {
+  std::string buffer;
+  size_t estimate = 0;
+  {
+      std::lock_guard<std::mutex> lock(mutex);
+      ++counters.acquired;
+      auto it = estimates.find(endpoint);
+      if (it != estimates.end()) estimate = it->second + it->second / 8;  // some slack for longer descriptions
+      if (!free_buffers.empty()) {
+          // the smallest buffer that fits, else the largest there is
+          auto best = free_buffers.begin();
+          for (auto candidate = free_buffers.begin(); candidate != free_buffers.end(); ++candidate) {
+              const bool fits = candidate->capacity() >= estimate;
+              const bool best_fits = best->capacity() >= estimate;
+              if (fits ? (!best_fits || candidate->capacity() < best->capacity())
+                       : (!best_fits && candidate->capacity() > best->capacity())) {
+                  best = candidate;
+              }
+          }
+          buffer = std::move(*best);
+          *best = std::move(free_buffers.back());
+          free_buffers.pop_back();
+          ++counters.recycled;
+      }
+  }
+  reserve(buffer, estimate);
+  return buffer;
+}
+
+void ResponseBufferPool::release(const std::string& endpoint, std::string&& buffer) {
+  const size_t size = buffer.size();
+  std::lock_guard<std::mutex> lock(mutex);
+  if (size > 0) {
+      // follow growth at once, shrink slowly so one short page doesn't undo it
+      size_t& estimate = estimates[endpoint];
+      estimate = std::max(size, estimate - estimate / 8);
+  }
+  if (free_buffers.size() >= max_buffers || buffer.capacity() > MAX_POOLED_CAPACITY) return;
+  buffer.clear();
+  free_buffers.push_back(std::move(buffer));
+}
+
+void ResponseBufferPool::presize(std::string& buffer, const HttpHeaders& headers) {
+  auto length = headers.find("content-length");
+  if (length == headers.end()) return;
+  // libcurl decodes gzip/br bodies, then Content-Length is only the compressed size
+  auto encoding = headers.find("content-encoding");
+  if (encoding != headers.end() && encoding->second != "identity") return;
+  const unsigned long long announced = std::strtoull(length->second.c_str(), nullptr, 10);
+  if (announced > 0 && announced <= MAX_POOLED_CAPACITY) reserve(buffer, static_cast<size_t>(announced));
+}
+
+void ResponseBufferPool::append(std::string& buffer, const char* data, size_t length) {
+  const size_t capacity = buffer.capacity();
+  buffer.append(data, length);
+  if (buffer.capacity() != capacity) {
+      std::lock_guard<std::mutex> lock(mutex);
+      ++counters.allocations;
+      ++counters.growths;
+  }
+}
+
+void ResponseBufferPool::reserve(std::string& buffer, size_t capacity) {
+  if (capacity <= buffer.capacity()) return;
+  buffer.reserve(capacity);
+  std::lock_guard<std::mutex> lock(mutex);
+  ++counters.allocations;
+}
+
+ResponseBufferPool::Stats ResponseBufferPool::stats() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return counters;
+}
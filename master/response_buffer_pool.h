@@ -0,0 +1,57 @@
+#ifndef RESPONSE_BUFFER_POOL_H
+#define RESPONSE_BUFFER_POOL_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "http_headers.h"
+
+// Response bodies are written into strings handed out by this pool and given
+// back once parsed, so their capacity is reused by the next request instead
+// of being freed and grown again append by append. Each buffer is reserved up
+// front: from Content-Length when the body isn't content-encoded, otherwise
+// from the largest recent body of the same endpoint. Thread-safe.
+class ResponseBufferPool {
+public:
+    struct Stats {
+        unsigned long long acquired;     // buffers handed out
+        unsigned long long recycled;     // ...of which came back from an earlier request
+        unsigned long long allocations;  // times a buffer's capacity had to grow
+        unsigned long long growths;      // ...of which while the body was being written
+    };
+
+    explicit ResponseBufferPool(size_t max_buffers = 16);
+
+    // Pool shared by every downloader that isn't handed one explicitly.
+    static std::shared_ptr<ResponseBufferPool> global();
+
+    // Requests with the same path and page size, e.g. "/search/repositories?per_page=100".
+    static std::string endpointKey(const std::string& url);
+
+    // An empty buffer with room for a typical body of endpoint.
+    std::string acquire(const std::string& endpoint);
+
+    // Learn the body size of endpoint and keep the buffer for the next request.
+    void release(const std::string& endpoint, std::string&& buffer);
+
+    // Grow buffer to the body size headers announce, before the first byte is written.
+    void presize(std::string& buffer, const HttpHeaders& headers);
+
+    // Append a chunk of the body, counting any reallocation it causes.
+    void append(std::string& buffer, const char* data, size_t length);
+
+    Stats stats() const;
+
+private:
+    void reserve(std::string& buffer, size_t capacity);
+
+    mutable std::mutex mutex;
+    size_t max_buffers;
+    std::vector<std::string> free_buffers;
+    std::unordered_map<std::string, size_t> estimates;  // endpoint -> expected body size
+    Stats counters{0, 0, 0, 0};
+};
+
+#endif
@@ -0,0 +1,68 @@
+#include "retry_policy.h"
+#include <algorithm>
+#include <random>
+
+RetryPolicy::Outcome RetryPolicy::classify(CURLcode result, long http_code, const HttpHeaders& headers,
+                                           const std::string& body) const {
+  if (result != CURLE_OK) {
+      switch (result) {
+          case CURLE_COULDNT_RESOLVE_HOST:
+          case CURLE_COULDNT_CONNECT:
+          case CURLE_OPERATION_TIMEDOUT:
+          case CURLE_SEND_ERROR:
+          case CURLE_RECV_ERROR:
+          case CURLE_GOT_NOTHING:
+          case CURLE_PARTIAL_FILE:
+          case CURLE_SSL_CONNECT_ERROR:
+          case CURLE_HTTP2:
+          case CURLE_HTTP2_STREAM:
+              return Outcome::Retry;
+          default:
+              return Outcome::Fail;
+      }
+  }
+
+  switch (http_code) {
+      case 502:
+      case 503:
+      case 504:
+          return Outcome::Retry;
+      case 403:
+      case 429: {
+          // a plain 403 is a permission problem; only rate limiting is worth repeating
+          if (headers.count("retry-after")) return Outcome::Retry;
+          auto remaining = headers.find("x-ratelimit-remaining");
+          if (remaining != headers.end() && remaining->second == "0") return Outcome::Retry;
+          if (body.find("secondary rate limit") != std::string::npos ||
+              body.find("abuse") != std::string::npos) {
+              return Outcome::Retry;
+          }
+          return http_code == 429 ? Outcome::Retry : Outcome::Fail;
+      }
+      default:
+          return http_code >= 500 ? Outcome::Fail : Outcome::Success;
+  }
+}
+
+std::chrono::milliseconds RetryPolicy::backoff(int attempt, const HttpHeaders& headers) const {
+  auto retry_after = headers.find("retry-after");
+  if (retry_after != headers.end()) {
+      try {
+          return std::chrono::seconds(std::max(0L, std::stol(retry_after->second)));
+      } catch (const std::exception&) {
+          // HTTP-date form, fall through to the computed delay
+      }
+  }
+
+  // full jitter: uniform in [0, min(max_delay, base_delay * 2^(attempt-1))]
+  const int shift = std::min(std::max(attempt - 1, 0), 20);
+  const long long ceiling = std::min<long long>(max_delay.count(), base_delay.count() * (1LL << shift));
+  thread_local std::mt19937_64 rng{std::random_device{}()};
+  std::uniform_int_distribution<long long> jitter(0, std::max(0LL, ceiling));
+  return std::chrono::milliseconds(jitter(rng));
+}
+
+std::string RetryPolicy::describe(CURLcode result, long http_code) {
+  if (result != CURLE_OK) return curl_easy_strerror(result);
+  return "HTTP " + std::to_string(http_code);
+}
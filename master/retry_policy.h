@@ -0,0 +1,30 @@
+#ifndef RETRY_POLICY_H
+#define RETRY_POLICY_H
+
+#include <chrono>
+#include <string>
+#include <curl/curl.h>
+#include "http_headers.h"
+
+// Decides whether a failed request is worth repeating and how long to wait
+// first. Transient transport errors, 502/503/504 and GitHub's secondary
+// (abuse detection) or exhausted rate limits are retried with capped
+// exponential backoff and full jitter; a Retry-After header always wins over
+// the computed delay.
+struct RetryPolicy {
+    enum class Outcome { Success, Retry, Fail };
+
+    int max_attempts = 4;                        // including the first one
+    std::chrono::milliseconds base_delay{500};
+    std::chrono::milliseconds max_delay{30000};
+
+    Outcome classify(CURLcode result, long http_code, const HttpHeaders& headers, const std::string& body) const;
+
+    // Delay before attempt number `attempt + 1`.
+    std::chrono::milliseconds backoff(int attempt, const HttpHeaders& headers) const;
+
+    // Short reason for log lines, e.g. "HTTP 503" or "Timeout was reached".
+    static std::string describe(CURLcode result, long http_code);
+};
+
+#endif
@@ -0,0 +1,55 @@
+#include "search_cache.h"
+
+SearchCache::SearchCache(size_t max_entries) : max_entries(max_entries == 0 ? 1 : max_entries) {}
+
+std::shared_ptr<SearchCache> SearchCache::global() {
+  static std::shared_ptr<SearchCache> cache = std::make_shared<SearchCache>();
+  return cache;
+}
+
+std::string SearchCache::conditionalEtag(const std::string& url) {
+  std::lock_guard<std::mutex> lock(mutex);
+  ++counters.requests;
+  auto it = entries.find(url);
+  if (it == entries.end()) return "";
+  ++counters.conditional;
+  return it->second.etag;
+}
+
+bool SearchCache::loadNotModified(const std::string& url, std::vector<ProjectInfo>& projects_out,
+                                  SearchPageMeta* meta_out) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = entries.find(url);
+  if (it == entries.end()) return false;
+  lru.splice(lru.begin(), lru, it->second.lru_position);
+  ++counters.hits;
+  ++counters.rate_limit_units_saved;
+  projects_out = it->second.projects;
+  if (meta_out) *meta_out = it->second.meta;
+  return true;
+}
+
+void SearchCache::store(const std::string& url, const std::string& etag, const std::vector<ProjectInfo>& projects,
+                        const SearchPageMeta& meta) {
+  if (etag.empty()) return;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = entries.find(url);
+  if (it != entries.end()) {
+      it->second.etag = etag;
+      it->second.projects = projects;
+      it->second.meta = meta;
+      lru.splice(lru.begin(), lru, it->second.lru_position);
+      return;
+  }
+  if (entries.size() >= max_entries) {
+      entries.erase(lru.back());
+      lru.pop_back();
+  }
+  lru.push_front(url);
+  entries.emplace(url, Entry{etag, projects, meta, lru.begin()});
+}
+
+SearchCache::Stats SearchCache::stats() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return counters;
+}
@@ -0,0 +1,61 @@
+#ifndef SEARCH_CACHE_H
+#define SEARCH_CACHE_H
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "project_info.h"
+#include "search_page_meta.h"
+
+// Conditional-request cache for search pages. Keyed by the full request URL,
+// each entry keeps the ETag GitHub sent along with the already parsed page
+// and its SearchPageMeta, so
+// a 304 Not Modified (which doesn't count against the rate limit) can be
+// answered without touching JSON again. Least recently used pages are evicted
+// once max_entries is reached. Thread-safe.
+class SearchCache {
+public:
+    struct Stats {
+        unsigned long long requests;        // cacheable requests sent
+        unsigned long long conditional;     // ...of which carried If-None-Match
+        unsigned long long hits;            // ...of which came back 304
+        unsigned long long rate_limit_units_saved;
+    };
+
+    explicit SearchCache(size_t max_entries = 1024);
+
+    // Cache shared by every downloader that isn't handed one explicitly.
+    static std::shared_ptr<SearchCache> global();
+
+    // ETag to send as If-None-Match for url, empty if the page isn't cached.
+    // Counts the request.
+    std::string conditionalEtag(const std::string& url);
+
+    // Answer a 304 for url from the cache. False if the entry has been evicted meanwhile.
+    bool loadNotModified(const std::string& url, std::vector<ProjectInfo>& projects_out,
+                         SearchPageMeta* meta_out = nullptr);
+
+    void store(const std::string& url, const std::string& etag, const std::vector<ProjectInfo>& projects,
+               const SearchPageMeta& meta = SearchPageMeta());
+
+    Stats stats() const;
+
+private:
+    struct Entry {
+        std::string etag;
+        std::vector<ProjectInfo> projects;
+        SearchPageMeta meta;
+        std::list<std::string>::iterator lru_position;
+    };
+
+    mutable std::mutex mutex;
+    size_t max_entries;
+    std::unordered_map<std::string, Entry> entries;
+    std::list<std::string> lru;  // front = most recently used
+    Stats counters{0, 0, 0, 0};
+};
+
+#endif
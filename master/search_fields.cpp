@@ -0,0 +1,331 @@
+#include "search_fields.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <sstream>
+
+static const char* const DEFAULT_FIELDS[] = {
+    "full_name", "html_url", "description", "pushed_at", "stargazers_count", "license.spdx_id"
+};
+
+// low-cardinality fields of a search item, see repeats()
+static const char* const REPEATED_FIELDS[] = {
+    "language", "default_branch", "visibility",
+    "owner.login", "owner.type", "owner.html_url", "owner.avatar_url", "owner.url",
+    "license.key", "license.name", "license.spdx_id", "license.url"
+};
+
+SearchFields::SearchFields()
+    : SearchFields(std::vector<std::string>(std::begin(DEFAULT_FIELDS), std::end(DEFAULT_FIELDS))) {
+  is_default = true;
+}
+
+SearchFields::SearchFields(const std::vector<std::string>& requested) : trie(1) {
+  size_t extras = 0;
+  for (const std::string& path : requested) {
+      if (path.empty() || contains(path)) continue;
+      const int slot = static_cast<int>(field_paths.size());
+      field_paths.push_back(path);
+
+      Builtin builtin = path == "id" ? Id : Extra;
+      for (int b = FullName; b <= License; ++b) {
+          if (path == DEFAULT_FIELDS[b]) builtin = static_cast<Builtin>(b);
+      }
+      builtins.push_back(builtin);
+      extra_index.push_back(builtin == Extra ? extras++ : 0);
+      addToTrie(path, slot);
+  }
+  // the id is needed to tell results apart; unrequested, it gets a slot past paths()
+  if (!contains("id")) {
+      builtins.push_back(Id);
+      extra_index.push_back(0);
+      addToTrie("id", static_cast<int>(builtins.size()) - 1);
+  }
+}
+
+// walk/extend the trie one key at a time
+void SearchFields::addToTrie(const std::string& path, int slot) {
+  int current = 0;
+  std::istringstream keys(path);
+  std::string key;
+  while (std::getline(keys, key, '.')) {
+      int next = child(current, key);
+      if (next < 0) {
+          next = static_cast<int>(trie.size());
+          trie.emplace_back();
+          trie[static_cast<size_t>(current)].children.emplace_back(key, next);
+      }
+      current = next;
+  }
+  trie[static_cast<size_t>(current)].slot = slot;
+}
+
+SearchFields SearchFields::parse(const std::string& list) {
+  std::vector<std::string> requested;
+  std::istringstream items(list);
+  std::string path;
+  while (std::getline(items, path, ',')) {
+      path.erase(0, path.find_first_not_of(" \t"));
+      path.erase(path.find_last_not_of(" \t") + 1);
+      if (!path.empty()) requested.push_back(path);
+  }
+  if (requested.empty()) return SearchFields();
+  SearchFields fields(requested);
+  fields.is_default = fields.field_paths == std::vector<std::string>(std::begin(DEFAULT_FIELDS), std::end(DEFAULT_FIELDS));
+  return fields;
+}
+
+bool SearchFields::contains(const std::string& path) const {
+  return std::find(field_paths.begin(), field_paths.end(), path) != field_paths.end();
+}
+
+std::vector<std::string> SearchFields::extraPaths() const {
+  std::vector<std::string> paths;
+  for (size_t slot = 0; slot < field_paths.size(); ++slot) {
+      if (builtins[slot] == Extra) paths.push_back(field_paths[slot]);
+  }
+  return paths;
+}
+
+bool SearchFields::repeats(const std::string& path) {
+  return std::find(std::begin(REPEATED_FIELDS), std::end(REPEATED_FIELDS), path) != std::end(REPEATED_FIELDS);
+}
+
+int SearchFields::child(int node, const std::string& key) const {
+  for (const auto& entry : trie[static_cast<size_t>(node)].children) {
+      if (entry.first == key) return entry.second;
+  }
+  return -1;
+}
+
+ProjectInfo SearchFields::blank(const ProjectInfo::allocator_type& allocator) const {
+  ProjectInfo project(allocator);
+  for (size_t slot = 0; slot < field_paths.size(); ++slot) {
+      switch (builtins[slot]) {
+          case FullName: project.name = "N/A"; break;  // no owner
+          case HtmlUrl: project.html_url = "N/A"; break;
+          case Description: project.description = "N/A"; break;
+          case PushedAt: case Stars: case License: case Id: break;  // already "missing"
+          case Extra: project.extra_fields.emplace_back(field_paths[slot], ""); break;
+      }
+  }
+  return project;
+}
+
+ProjectInfoView SearchFields::blankView() const {
+  ProjectInfoView view;
+  size_t extras = 0;
+  for (size_t slot = 0; slot < field_paths.size(); ++slot) {
+      switch (builtins[slot]) {
+          case FullName: view.name = "N/A"; break;
+          case HtmlUrl: view.html_url = "N/A"; break;
+          case Description: view.description = "N/A"; break;
+          case PushedAt: case Stars: case License: case Id: break;  // already "missing"
+          case Extra: ++extras; break;
+      }
+  }
+  if (extras) view.extra_values.assign(extras, std::string_view());
+  return view;
+}
+
+// number literals are short and always followed by a structural in the body,
+// but string_view promises no terminator, so copy before strtod
+static int parseStars(std::string_view value) {
+  char digits[32];
+  const size_t length = std::min(value.size(), sizeof(digits) - 1);
+  value.copy(digits, length);
+  digits[length] = '\0';
+  return static_cast<int>(std::strtod(digits, nullptr));
+}
+
+// ids are plain integers; anything else (null, a string) leaves 0
+static std::int64_t parseId(std::string_view value) {
+  std::int64_t id = 0;
+  for (char c : value) {
+      if (c < '0' || c > '9' || id > (INT64_MAX - 9) / 10) return 0;
+      id = id * 10 + (c - '0');
+  }
+  return id;
+}
+
+static std::int64_t parsePushedAt(std::string_view value) {
+  std::int64_t seconds;
+  return parseIsoTimestamp(value, seconds) ? seconds : NO_TIMESTAMP;
+}
+
+void SearchFields::assign(ProjectInfoView& view, int slot, ValueKind kind, std::string_view value) const {
+  const size_t index = static_cast<size_t>(slot);
+  const bool is_string = kind == ValueKind::String;
+  switch (builtins[index]) {
+      case FullName: if (is_string) view.setName(value); break;
+      case HtmlUrl: if (is_string) view.html_url = value; break;
+      case PushedAt: view.pushed_at = is_string ? parsePushedAt(value) : NO_TIMESTAMP; break;
+      case Description:
+          if (is_string) view.description = value;
+          else if (value == "null") view.description = "N/A";
+          break;
+      case Stars:
+          if (kind == ValueKind::Literal && value != "null" && value != "true" && value != "false") {
+              view.stargazers_count = parseStars(value);
+          }
+          break;
+      case License:
+          view.license = is_string ? spdxLicense(value) : SpdxLicense::Unknown;
+          break;
+      case Id:
+          if (kind == ValueKind::Literal) view.id = parseId(value);
+          break;
+      case Extra:
+          view.extra_values[extra_index[index]] = value;
+          break;
+  }
+}
+
+void SearchFields::assign(ProjectInfo& project, int slot, ValueKind kind, std::string_view value) const {
+  const size_t index = static_cast<size_t>(slot);
+  const bool is_string = kind == ValueKind::String;
+  switch (builtins[index]) {
+      case FullName: if (is_string) project.setName(value); break;
+      case HtmlUrl: if (is_string) project.html_url = value; break;
+      case PushedAt: project.pushed_at = is_string ? parsePushedAt(value) : NO_TIMESTAMP; break;
+      case Description:
+          if (is_string) project.description = value;
+          else if (value == "null") project.description = "N/A";
+          break;
+      case Stars:
+          if (kind == ValueKind::Literal && value != "null" && value != "true" && value != "false") {
+              project.stargazers_count = parseStars(value);
+          }
+          break;
+      case License:
+          project.license = is_string ? spdxLicense(value) : SpdxLicense::Unknown;
+          break;
+      case Id:
+          if (kind == ValueKind::Literal) project.id = parseId(value);
+          break;
+      case Extra:
+          project.extra_fields[extra_index[index]].second = value;
+          break;
+  }
+}
+
+ProjectInfo SearchFields::extract(const nlohmann::json& item) const {
+  ProjectInfo project = blank();
+  assignMembers(project, 0, item);
+  return project;
+}
+
+ProjectInfo SearchFields::extract(const ArenaJson& item, const ProjectInfo::allocator_type& allocator) const {
+  ProjectInfo project = blank(allocator);
+  assignMembers(project, 0, item);
+  return project;
+}
+
+void SearchFields::assignChildren(ProjectInfo& project, int node, const nlohmann::json& value) const {
+  assignMembers(project, node, value);
+}
+
+void SearchFields::assignChildren(ProjectInfo& project, int node, const ArenaJson& value) const {
+  assignMembers(project, node, value);
+}
+
+template <typename Json>
+void SearchFields::assignMembers(ProjectInfo& project, int node, const Json& value) const {
+  if (!value.is_object()) return;
+  for (const auto& entry : trie[static_cast<size_t>(node)].children) {
+      auto it = value.find(std::string_view(entry.first));
+      if (it == value.end()) continue;
+      const int slot = trie[static_cast<size_t>(entry.second)].slot;
+      if (slot >= 0) {
+          if (it->is_string()) {
+              assign(project, slot, ValueKind::String, it->template get_ref<const typename Json::string_t&>());
+          } else {
+              const typename Json::string_t text = it->dump();
+              assign(project, slot, it->is_structured() ? ValueKind::Raw : ValueKind::Literal, text);
+          }
+      }
+      assignMembers(project, entry.second, *it);
+  }
+}
+
+std::vector<std::pair<std::string, std::string>> SearchFields::values(const ProjectInfo& project) const {
+  std::vector<std::pair<std::string, std::string>> out;
+  for (size_t slot = 0; slot < field_paths.size(); ++slot) {
+      std::string value;
+      switch (builtins[slot]) {
+          case FullName: value = project.name; break;
+          case HtmlUrl: value = project.html_url; break;
+          case Description: value = project.description; break;
+          case PushedAt: value = project.pushedAtText(); break;
+          case Stars: value = std::to_string(project.stargazers_count); break;
+          case License: value = project.licenseName(); break;
+          case Id: value = std::to_string(project.id); break;
+          case Extra:
+              if (extra_index[slot] < project.extra_fields.size()) value = project.extra_fields[extra_index[slot]].second;
+              break;
+      }
+      out.emplace_back(field_paths[slot], value);
+  }
+  return out;
+}
+
+std::vector<std::pair<std::string, std::string>> SearchFields::values(const ProjectInfoView& view) const {
+  std::vector<std::pair<std::string, std::string>> out;
+  for (size_t slot = 0; slot < field_paths.size(); ++slot) {
+      std::string value;
+      switch (builtins[slot]) {
+          case FullName: value = view.name; break;
+          case HtmlUrl: value = view.html_url; break;
+          case Description: value = view.description; break;
+          case PushedAt: value = view.pushedAtText(); break;
+          case Stars: value = std::to_string(view.stargazers_count); break;
+          case License: value = view.licenseName(); break;
+          case Id: value = std::to_string(view.id); break;
+          case Extra:
+              if (extra_index[slot] < view.extra_values.size()) value = view.extra_values[extra_index[slot]];
+              break;
+      }
+      out.emplace_back(field_paths[slot], value);
+  }
+  return out;
+}
+
+ProjectInfo SearchFields::materialize(const ProjectInfoView& view) const {
+  ProjectInfo project;
+  project.name = view.name;
+  project.owner_length = view.owner_length;
+  project.html_url = view.html_url;
+  project.description = view.description;
+  project.id = view.id;
+  project.pushed_at = view.pushed_at;
+  project.stargazers_count = view.stargazers_count;
+  project.license = view.license;
+  for (size_t slot = 0; slot < field_paths.size(); ++slot) {
+      if (builtins[slot] != Extra) continue;
+      const size_t extra = extra_index[slot];
+      project.extra_fields.emplace_back(field_paths[slot],
+                                        extra < view.extra_values.size() ? std::string(view.extra_values[extra]) : "");
+  }
+  return project;
+}
+
+ProjectInfoView SearchFields::view(const ProjectInfo& project) const {
+  ProjectInfoView view;
+  view.name = project.name;
+  view.owner_length = project.owner_length;
+  view.html_url = project.html_url;
+  view.description = project.description;
+  view.id = project.id;
+  view.pushed_at = project.pushed_at;
+  view.stargazers_count = project.stargazers_count;
+  view.license = project.license;
+  for (const auto& extra : project.extra_fields) view.extra_values.push_back(extra.second);
+  return view;
+}
+
+bool SearchFields::hasNestedRequests() const {
+  for (const Node& node : trie) {
+      if (node.slot >= 0 && !node.children.empty()) return true;
+  }
+  return false;
+}
@@ -0,0 +1,94 @@
+#ifndef SEARCH_FIELDS_H
+#define SEARCH_FIELDS_H
+
+#include <string>
+#include <utility>
+#include <vector>
+#include "arena_json.h"
+#include "json.hpp"
+#include "project_info.h"
+
+// The fields a search extracts from each item, as dotted paths relative to the
+// item ("full_name", "license.spdx_id", "owner.login"). By default the six
+// ProjectInfo is made of; any other path ends up in ProjectInfo::extra_fields,
+// strings decoded, numbers/booleans/null as their JSON text and objects or
+// arrays as the raw JSON of the response. The item's "id" is extracted
+// into ProjectInfo::id whether or not it was requested.
+class SearchFields {
+public:
+    // full_name, html_url, description, pushed_at, stargazers_count, license.spdx_id
+    SearchFields();
+
+    // Comma separated paths as given to --fields. Empty means the defaults.
+    static SearchFields parse(const std::string& list);
+
+    const std::vector<std::string>& paths() const { return field_paths; }
+    bool isDefault() const { return is_default; }
+    bool contains(const std::string& path) const;
+    // Requested paths that end up in extra_fields, in extra_fields order.
+    std::vector<std::string> extraPaths() const;
+
+    // Whether path holds a value shared by many items (owner logins,
+    // languages, license names...), which ProjectTable interns.
+    static bool repeats(const std::string& path);
+
+    // ProjectInfo with every requested field at its "missing" value, its
+    // strings allocated with allocator.
+    ProjectInfo blank(const ProjectInfo::allocator_type& allocator = {}) const;
+    ProjectInfoView blankView() const;
+
+    // How a value was written in the JSON.
+    enum class ValueKind { String, Literal, Raw };
+
+    // Store the value of slot (the index of its path) into project.
+    void assign(ProjectInfo& project, int slot, ValueKind kind, std::string_view value) const;
+    // Same for a view; value has to outlive it.
+    void assign(ProjectInfoView& view, int slot, ValueKind kind, std::string_view value) const;
+
+    // DOM version of the projection; the stream parser's fallback and oracle.
+    ProjectInfo extract(const nlohmann::json& item) const;
+    // From an arena DOM, into strings allocated with allocator.
+    ProjectInfo extract(const ArenaJson& item, const ProjectInfo::allocator_type& allocator) const;
+    // Fields below node in value, for an object requested along with some of its members.
+    void assignChildren(ProjectInfo& project, int node, const nlohmann::json& value) const;
+    void assignChildren(ProjectInfo& project, int node, const ArenaJson& value) const;
+
+    // The requested path of each value of project, in requested order.
+    std::vector<std::pair<std::string, std::string>> values(const ProjectInfo& project) const;
+    std::vector<std::pair<std::string, std::string>> values(const ProjectInfoView& view) const;
+
+    // Owned copy of view.
+    ProjectInfo materialize(const ProjectInfoView& view) const;
+    // View of project, pointing into its strings.
+    ProjectInfoView view(const ProjectInfo& project) const;
+
+    // Whether some requested object has requested members too. Views can't
+    // express that: the raw object text and its decoded members would overlap.
+    bool hasNestedRequests() const;
+
+    // Requested paths as a trie over object keys, walked by SearchStreamParser.
+    // Node 0 is the item itself.
+    struct Node {
+        int slot = -1;  // index into paths() when this path was requested (or the hidden id slot)
+        std::vector<std::pair<std::string, int>> children;
+    };
+    const Node& node(int index) const { return trie[static_cast<size_t>(index)]; }
+    int child(int node, const std::string& key) const;
+
+private:
+    void addToTrie(const std::string& path, int slot);
+
+    enum Builtin { FullName, HtmlUrl, Description, PushedAt, Stars, License, Id, Extra };
+
+    explicit SearchFields(const std::vector<std::string>& requested);
+    template <typename Json>
+    void assignMembers(ProjectInfo& project, int node, const Json& value) const;
+
+    std::vector<std::string> field_paths;
+    std::vector<Builtin> builtins;        // per slot, plus the id's when it wasn't requested
+    std::vector<size_t> extra_index;      // per slot, position in extra_fields
+    std::vector<Node> trie;
+    bool is_default = false;
+};
+
+#endif
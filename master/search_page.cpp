@@ -0,0 +1,51 @@
+#include "search_page.h"
+
+// shared by every page with the default fields, so those don't copy the trie
+std::shared_ptr<const SearchFields> SearchPage::defaultFields() {
+  static std::shared_ptr<const SearchFields> fields = std::make_shared<const SearchFields>();
+  return fields;
+}
+
+void SearchPage::setFields(const SearchFields& fields) {
+  if (fields.isDefault()) {
+      field_set = defaultFields();
+  } else if (field_set.get() != &fields) {
+      field_set = std::make_shared<const SearchFields>(fields);
+  }
+}
+
+bool SearchPage::parse(std::shared_ptr<std::string> page_body, const SearchFields& fields) {
+  StructuralSearchParser parser(fields);
+  return parse(std::move(page_body), parser);
+}
+
+bool SearchPage::parse(std::shared_ptr<std::string> page_body, StructuralSearchParser& parser) {
+  clear();
+  if (!page_body) return false;
+  if (!parser.parseInPlace(*page_body, views) || !parser.sawItems()) {
+      views.clear();
+      return false;
+  }
+  body = std::move(page_body);
+  setFields(parser.getFields());
+  return true;
+}
+
+void SearchPage::assign(std::vector<ProjectInfo> owned, const SearchFields& fields) {
+  clear();
+  projects = std::make_shared<std::vector<ProjectInfo>>(std::move(owned));
+  setFields(fields);
+  views.reserve(projects->size());
+  for (const ProjectInfo& project : *projects) views.push_back(field_set->view(project));
+}
+
+void SearchPage::clear() {
+  views.clear();
+  body.reset();
+  projects.reset();
+}
+
+void SearchPage::appendTo(std::vector<ProjectInfo>& projects_out) const {
+  projects_out.reserve(projects_out.size() + views.size());
+  for (const ProjectInfoView& view : views) projects_out.push_back(field_set->materialize(view));
+}
@@ -0,0 +1,53 @@
+#ifndef SEARCH_PAGE_H
+#define SEARCH_PAGE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "project_info.h"
+#include "search_fields.h"
+#include "structural_search_parser.h"
+
+// One page of search results as ProjectInfoViews into storage the page owns:
+// normally the response body itself, whose strings are decoded in place, or
+// ProjectInfos when the page came from the cache or the json.hpp fallback.
+// Copies share that storage (it is reference counted), and the views stay
+// valid as long as any copy is alive.
+class SearchPage {
+public:
+    SearchPage() = default;
+
+    // Take body over and view its items. False when it isn't a search response
+    // the structural parser accepts; body is then left as it was for the
+    // fallback path, unless it was malformed JSON to begin with.
+    bool parse(std::shared_ptr<std::string> body, const SearchFields& fields = SearchFields());
+    // With a parser kept across pages, whose index buffers are then reused.
+    bool parse(std::shared_ptr<std::string> body, StructuralSearchParser& parser);
+
+    // Own already parsed projects instead.
+    void assign(std::vector<ProjectInfo> projects, const SearchFields& fields = SearchFields());
+
+    void clear();
+
+    const std::vector<ProjectInfoView>& items() const { return views; }
+    size_t size() const { return views.size(); }
+    bool empty() const { return views.empty(); }
+    const ProjectInfoView& operator[](size_t index) const { return views[index]; }
+
+    const SearchFields& fields() const { return *field_set; }
+
+    // Owned copies, for callers that keep results beyond the page.
+    ProjectInfo materialize(size_t index) const { return field_set->materialize(views[index]); }
+    void appendTo(std::vector<ProjectInfo>& projects_out) const;
+
+private:
+    static std::shared_ptr<const SearchFields> defaultFields();
+    void setFields(const SearchFields& fields);
+
+    std::shared_ptr<std::string> body;
+    std::shared_ptr<std::vector<ProjectInfo>> projects;
+    std::shared_ptr<const SearchFields> field_set = defaultFields();  // pages with custom fields get a copy
+    std::vector<ProjectInfoView> views;
+};
+
+#endif
@@ -0,0 +1,95 @@
+#include "search_page_meta.h"
+#include <algorithm>
+#include <string_view>
+
+namespace {
+
+constexpr long long MAX_REACHABLE_RESULTS = 1000;
+
+// position just past "key": in the first or last bytes of body, npos without one
+size_t findTopLevelKey(std::string_view body, std::string_view key) {
+  const size_t edge = 256;
+  size_t pos;
+  if (body.size() <= 2 * edge) {
+      pos = body.find(key);
+  } else {
+      pos = body.substr(0, edge).find(key);
+      if (pos == std::string_view::npos) {
+          const size_t tail = body.size() - edge;
+          pos = body.substr(tail).find(key);
+          if (pos != std::string_view::npos) pos += tail;
+      }
+  }
+  if (pos == std::string_view::npos) return pos;
+  pos = body.find_first_not_of(" \t\r\n", pos + key.size());
+  if (pos == std::string_view::npos || body[pos] != ':') return std::string_view::npos;
+  return body.find_first_not_of(" \t\r\n", pos + 1);
+}
+
+// the page=N parameter of a Link target (not per_page=)
+int pageParameter(std::string_view url) {
+  for (size_t pos = url.find("page="); pos != std::string_view::npos; pos = url.find("page=", pos + 1)) {
+      if (pos == 0 || (url[pos - 1] != '?' && url[pos - 1] != '&')) continue;
+      int page = 0;
+      for (pos += 5; pos < url.size() && url[pos] >= '0' && url[pos] <= '9'; ++pos) page = page * 10 + (url[pos] - '0');
+      return page;
+  }
+  return 0;
+}
+
+// the '>' closing a Link target: the one its ;-parameters follow, so a raw '>'
+// or ',' inside a target that wasn't percent-encoded doesn't end it early
+size_t targetEnd(std::string_view value, size_t open) {
+  for (size_t close = value.find('>', open + 1); close != std::string_view::npos;
+       close = value.find('>', close + 1)) {
+      const size_t next = value.find_first_not_of(" \t", close + 1);
+      if (next != std::string_view::npos && value[next] == ';') return close;
+  }
+  return std::string_view::npos;
+}
+
+}  // namespace
+
+int SearchPageMeta::pageCount(int page_size) const {
+  if (total_count >= 0) {
+      const long long reachable = std::min(total_count, MAX_REACHABLE_RESULTS);
+      return static_cast<int>((reachable + page_size - 1) / page_size);
+  }
+  if (last_page > 0) return last_page;
+  if (prev_page > 0 && next_page == 0) return prev_page + 1;
+  return -1;
+}
+
+SearchPageMeta SearchPageMeta::parse(const std::string& body, const HttpHeaders& headers) {
+  SearchPageMeta meta;
+  const std::string_view text(body);
+  size_t pos = findTopLevelKey(text, "\"total_count\"");
+  if (pos != std::string_view::npos && text[pos] >= '0' && text[pos] <= '9') {
+      meta.total_count = 0;
+      for (; pos < text.size() && text[pos] >= '0' && text[pos] <= '9'; ++pos) {
+          meta.total_count = meta.total_count * 10 + (text[pos] - '0');
+      }
+  }
+  pos = findTopLevelKey(text, "\"incomplete_results\"");
+  meta.incomplete_results = pos != std::string_view::npos && text.compare(pos, 4, "true") == 0;
+
+  // <https://...&page=2>; rel="next", <https://...&page=34>; rel="last"
+  auto link = headers.find("link");
+  if (link != headers.end()) {
+      const std::string_view value(link->second);
+      for (size_t open = value.find('<'); open != std::string_view::npos;) {
+          const size_t close = targetEnd(value, open);
+          if (close == std::string_view::npos) break;
+          // the parameters run to the next ',', which rel="..." never contains
+          size_t end = value.find(',', close);
+          if (end == std::string_view::npos) end = value.size();
+          const int page = pageParameter(value.substr(open + 1, close - open - 1));
+          const std::string_view rel = value.substr(close, end - close);
+          if (rel.find("rel=\"next\"") != std::string_view::npos) meta.next_page = page;
+          else if (rel.find("rel=\"prev\"") != std::string_view::npos) meta.prev_page = page;
+          else if (rel.find("rel=\"last\"") != std::string_view::npos) meta.last_page = page;
+          open = value.find('<', end);
+      }
+  }
+  return meta;
+}
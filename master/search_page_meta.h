@@ -0,0 +1,30 @@
+#ifndef SEARCH_PAGE_META_H
+#define SEARCH_PAGE_META_H
+
+#include <string>
+#include "http_headers.h"
+
+// What a search response says about the result set beyond its items: the
+// top-level total_count and incomplete_results, and the neighbouring pages
+// its Link header points to. Enough to know how many pages exist before
+// asking for them.
+struct SearchPageMeta {
+    long long total_count = -1;       // -1 when the response didn't say
+    bool incomplete_results = false;  // the search timed out; total_count is a lower bound
+    int next_page = 0;                // Link rel="next", 0 if none
+    int prev_page = 0;                // rel="prev"
+    int last_page = 0;                // rel="last"; GitHub leaves it out on the last page itself
+
+    bool known() const { return total_count >= 0 || last_page > 0 || (prev_page > 0 && next_page == 0); }
+
+    // Pages of page_size results that can be paged through (GitHub stops
+    // after 1000 results), -1 when the response said nothing about it.
+    int pageCount(int page_size) const;
+
+    // From a 200 response. total_count and incomplete_results sit outside
+    // the items array, so only the first and last few hundred bytes of the
+    // body are looked at.
+    static SearchPageMeta parse(const std::string& body, const HttpHeaders& headers);
+};
+
+#endif
@@ -0,0 +1,137 @@
+#include "search_shard.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include "iso_time.h"
+
+namespace {
+
+// one end of a range: a star count, or a YYYY-MM-DD date as days since 1970-01-01
+bool parseBound(const std::string& text, bool date, std::int64_t& value) {
+  if (date) {
+      std::int64_t seconds;
+      if (text.size() != 10 || !parseIsoTimestamp(text + "T00:00:00Z", seconds)) return false;
+      value = seconds / 86400 - (seconds % 86400 < 0);
+      return true;
+  }
+  if (text.empty() || text.size() > 12 || text.find_first_not_of("0123456789") != std::string::npos) return false;
+  value = std::stoll(text);
+  return true;
+}
+
+// narrow [lo, hi] by a qualifier value: >=10, >10, <=10, <10, 5..50, 5..*, *..50 or 42
+bool narrowRange(const std::string& value, bool date, std::int64_t& lo, std::int64_t& hi) {
+  std::int64_t bound;
+  const size_t dots = value.find("..");
+  if (dots != std::string::npos) {
+      const std::string from = value.substr(0, dots);
+      const std::string to = value.substr(dots + 2);
+      if (from != "*") {
+          if (!parseBound(from, date, bound)) return false;
+          lo = std::max(lo, bound);
+      }
+      if (to != "*") {
+          if (!parseBound(to, date, bound)) return false;
+          hi = std::min(hi, bound);
+      }
+      return true;
+  }
+  const size_t op = value.compare(0, 2, ">=") == 0 || value.compare(0, 2, "<=") == 0 ? 2
+                    : !value.empty() && (value[0] == '>' || value[0] == '<') ? 1 : 0;
+  if (!parseBound(value.substr(op), date, bound)) return false;
+  const std::string comparison = value.substr(0, op);
+  if (comparison == ">=") {
+      lo = std::max(lo, bound);
+  } else if (comparison == ">") {
+      lo = std::max(lo, bound + 1);
+  } else if (comparison == "<=") {
+      hi = std::min(hi, bound);
+  } else if (comparison == "<") {
+      hi = std::min(hi, bound - 1);
+  } else {
+      lo = std::max(lo, bound);
+      hi = std::min(hi, bound);
+  }
+  return true;
+}
+
+std::string formatDay(std::int64_t day) {
+  return formatIsoTimestamp(day * 86400).substr(0, 10);
+}
+
+}  // namespace
+
+SearchShard SearchShard::fromQualifiers(const std::vector<std::string>& qualifiers, std::vector<std::string>& others) {
+  SearchShard shard;
+  others.clear();
+  for (const std::string& qualifier : qualifiers) {
+      // a qualifier argument may hold several space separated ones
+      std::istringstream words(qualifier);
+      std::string word;
+      while (words >> word) {
+          if (word.compare(0, 6, "stars:") == 0) {
+              if (narrowRange(word.substr(6), false, shard.stars_min, shard.stars_max)) continue;
+              shard.stars_splittable = false;
+          } else if (word.compare(0, 8, "created:") == 0) {
+              if (narrowRange(word.substr(8), true, shard.created_min, shard.created_max)) continue;
+              shard.created_splittable = false;
+          }
+          others.push_back(word);
+      }
+  }
+  return shard;
+}
+
+std::vector<std::string> SearchShard::qualifiers(const std::vector<std::string>& others) const {
+  std::vector<std::string> all = others;
+  if (stars_splittable && (stars_min != 0 || stars_max != OPEN)) {
+      all.push_back(stars_max == OPEN ? "stars:>=" + std::to_string(stars_min)
+                                      : "stars:" + std::to_string(stars_min) + ".." + std::to_string(stars_max));
+  }
+  if (created_splittable && (created_min != FIRST_CREATED_DAY || created_max != OPEN)) {
+      all.push_back(created_max == OPEN ? "created:>=" + formatDay(created_min)
+                                        : "created:" + formatDay(created_min) + ".." + formatDay(created_max));
+  }
+  return all;
+}
+
+bool SearchShard::split(SearchShard& low, SearchShard& high, std::int64_t today) const {
+  low = *this;
+  high = *this;
+  low.total_count = high.total_count = -1;
+  if (stars_splittable && stars_min < stars_max) {
+      // star counts thin out fast, so the open top end takes everything past a
+      // few times the bottom and closed ranges split at their geometric middle
+      std::int64_t middle = stars_max == OPEN
+                                ? stars_min * 4 + 100
+                                : static_cast<std::int64_t>(std::sqrt((stars_min + 1.0) * (stars_max + 1.0))) - 1;
+      middle = std::clamp(middle, stars_min, stars_max - 1);
+      low.stars_max = middle;
+      high.stars_min = middle + 1;
+      return true;
+  }
+  const std::int64_t created_end = created_max == OPEN ? today : created_max;
+  if (created_splittable && created_min < created_end) {
+      const std::int64_t middle = created_min + (created_end - created_min) / 2;
+      low.created_max = middle;
+      high.created_min = middle + 1;
+      return true;
+  }
+  return false;
+}
+
+bool SearchShard::merge(const SearchShard& a, const SearchShard& b, SearchShard& merged) {
+  const bool same_stars = a.stars_min == b.stars_min && a.stars_max == b.stars_max;
+  const bool same_created = a.created_min == b.created_min && a.created_max == b.created_max;
+  merged = a;
+  merged.total_count = a.total_count + b.total_count;
+  if (same_created && a.stars_max != OPEN && a.stars_max + 1 == b.stars_min) {
+      merged.stars_max = b.stars_max;
+      return true;
+  }
+  if (same_stars && a.created_max != OPEN && a.created_max + 1 == b.created_min) {
+      merged.created_max = b.created_max;
+      return true;
+  }
+  return false;
+}
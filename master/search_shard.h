@@ -0,0 +1,50 @@
+#ifndef SEARCH_SHARD_H
+#define SEARCH_SHARD_H
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+// A slice of a search query, narrowed by stars: and created: ranges so that
+// it matches no more than the 1000 results GitHub lets one query page
+// through. Shards of the same query never overlap.
+struct SearchShard {
+    static constexpr std::int64_t OPEN = std::numeric_limits<std::int64_t>::max();  // no upper bound
+    static constexpr std::int64_t FIRST_CREATED_DAY = 13787;  // 2007-10-01, before GitHub's first repository
+
+    std::int64_t stars_min = 0;
+    std::int64_t stars_max = OPEN;
+    std::int64_t created_min = FIRST_CREATED_DAY;  // days since 1970-01-01, inclusive
+    std::int64_t created_max = OPEN;
+    bool stars_splittable = true;    // false when the query's own stars: wasn't understood
+    bool created_splittable = true;  // same for created:
+    long long total_count = -1;      // results the API reported, -1 until probed
+
+    // Shard for a whole query: its stars: and created: qualifiers become the
+    // ranges, every other qualifier is returned in others.
+    static SearchShard fromQualifiers(const std::vector<std::string>& qualifiers, std::vector<std::string>& others);
+
+    // others plus this shard's ranges, as qualifiers.
+    std::vector<std::string> qualifiers(const std::vector<std::string>& others) const;
+
+    // Two halves covering this shard: by stars while that range holds more
+    // than one value, then by creation date (up to today, in days). False
+    // when neither range can be narrowed any more.
+    bool split(SearchShard& low, SearchShard& high, std::int64_t today) const;
+
+    // a followed by b as one shard, when they differ in one range and meet there.
+    static bool merge(const SearchShard& a, const SearchShard& b, SearchShard& merged);
+};
+
+// How a query was cut into shards, and what fetching them took.
+struct ShardPlan {
+    std::vector<std::string> qualifiers;  // the query's qualifiers besides stars: and created:
+    std::vector<SearchShard> shards;      // in stars, then creation order
+    long long total_count = -1;           // of the whole query
+    int probes = 0;                       // one-result requests that measured shards
+    int page_requests = 0;                // search requests that fetched results
+    size_t duplicates = 0;                // results dropped because an earlier shard had them
+};
+
+#endif
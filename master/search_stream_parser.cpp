@@ -0,0 +1,343 @@
+#include "search_stream_parser.h"
+#include "json_text.h"
+
+static const int ROOT = -3;  // valueTarget() for the document itself
+
+SearchStreamParser::SearchStreamParser(const SearchFields& fields, ItemCallback on_item)
+    : fields(fields), on_item(std::move(on_item)) {}
+
+void SearchStreamParser::reset() {
+  collected.clear();
+  current = ProjectInfo();
+  stack.clear();
+  state = State::Value;
+  scratch.clear();
+  capturing = false;
+  value_slot = NONE;
+  high_surrogate = 0;
+  saw_items = false;
+  item_count = 0;
+  error_message.clear();
+}
+
+bool SearchStreamParser::fail(const char* message) {
+  state = State::Error;
+  error_message = message;
+  return false;
+}
+
+// what the value starting now is: ROOT, ITEMS, a trie node, or NONE
+int SearchStreamParser::valueTarget() const {
+  if (stack.empty()) return ROOT;
+  const Level& top = stack.back();
+  if (top.frame == Frame::Items) return 0;
+  return top.pending;
+}
+
+void SearchStreamParser::beginValue(char c) {
+  const int target = valueTarget();
+  value_slot = target >= 0 ? fields.node(target).slot : NONE;
+
+  skip_node = target;
+  if (c == '{' && (target == ROOT || target == 0 ||
+                   (target > 0 && value_slot == NONE && !fields.node(target).children.empty()))) {
+      if (target == 0) current = fields.blank();
+      stack.push_back(Level{'{', target == ROOT ? Frame::Root : Frame::Node, target, NONE});
+      state = State::ObjectStart;
+  } else if (c == '[' && target == ITEMS) {
+      saw_items = true;
+      stack.push_back(Level{'[', Frame::Items, NONE, NONE});
+      state = State::ArrayStart;
+  } else if (c == '{' || c == '[') {
+      // not on the way to a requested field: step over it, keeping the raw
+      // text only when the whole object/array was asked for
+      capturing = value_slot != NONE;
+      scratch.clear();
+      if (capturing) scratch += c;
+      skip_depth = 1;
+      skip_in_string = false;
+      skip_escape = false;
+      state = State::Skip;
+  } else if (c == '"') {
+      beginString(false, value_slot != NONE);
+  } else {
+      scratch.clear();
+      state = State::Literal;
+  }
+}
+
+void SearchStreamParser::endValue() {
+  state = stack.empty() ? State::Done : State::AfterValue;
+}
+
+void SearchStreamParser::endContainer(char type) {
+  if (stack.empty() || stack.back().type != type) {
+      fail("mismatched bracket");
+      return;
+  }
+  const Level level = stack.back();
+  stack.pop_back();
+  if (level.frame == Frame::Node && level.node == 0) {
+      ++item_count;
+      if (on_item) {
+          on_item(std::move(current));
+      } else {
+          collected.push_back(std::move(current));
+      }
+  }
+  endValue();
+}
+
+void SearchStreamParser::beginString(bool key, bool capture) {
+  string_is_key = key;
+  capturing = capture;
+  scratch.clear();
+  high_surrogate = 0;
+  state = State::String;
+}
+
+void SearchStreamParser::endString() {
+  if (string_is_key) {
+      Level& top = stack.back();
+      if (top.frame == Frame::Root) {
+          top.pending = scratch == "items" ? ITEMS : NONE;
+      } else {
+          top.pending = fields.child(top.node, scratch);
+      }
+      state = State::Colon;
+      return;
+  }
+  if (value_slot != NONE) fields.assign(current, value_slot, SearchFields::ValueKind::String, scratch);
+  endValue();
+}
+
+bool SearchStreamParser::endLiteral() {
+  if (!isJsonLiteral(scratch)) return fail("invalid literal");
+  if (value_slot != NONE) fields.assign(current, value_slot, SearchFields::ValueKind::Literal, scratch);
+  endValue();
+  return true;
+}
+
+// a \u escape; surrogates have to come in high-low pairs, as json.hpp insists
+bool SearchStreamParser::appendCodepoint(unsigned code) {
+  if (code >= 0xD800 && code <= 0xDBFF) {
+      if (high_surrogate) return fail("unpaired surrogate");
+      high_surrogate = code;
+      return true;
+  }
+  const bool low_surrogate = code >= 0xDC00 && code <= 0xDFFF;
+  if (low_surrogate != (high_surrogate != 0)) return fail("unpaired surrogate");
+  if (low_surrogate) code = 0x10000 + ((high_surrogate - 0xD800) << 10) + (code - 0xDC00);
+  high_surrogate = 0;
+  if (capturing) appendUtf8(scratch, code);
+  return true;
+}
+
+// Steps over the rest of a skipped object/array: only quotes, backslashes
+// inside strings and brackets outside of them matter. Returns the bytes used.
+size_t SearchStreamParser::skip(const char* data, size_t length) {
+  size_t i = 0;
+  while (i < length) {
+      if (skip_in_string) {
+          if (skip_escape) {
+              skip_escape = false;
+              ++i;
+              continue;
+          }
+          while (i < length && data[i] != '"' && data[i] != '\\') ++i;
+          if (i == length) break;
+          if (data[i] == '\\') skip_escape = true;
+          else skip_in_string = false;
+          ++i;
+          continue;
+      }
+      const char c = data[i++];
+      if (c == '"') {
+          skip_in_string = true;
+      } else if (c == '{' || c == '[') {
+          ++skip_depth;
+      } else if ((c == '}' || c == ']') && --skip_depth == 0) {
+          if (capturing) {
+              scratch.append(data, i);
+              if (!fields.node(skip_node).children.empty()) {
+                  // members were asked for too; rare enough to go through the DOM
+                  try {
+                      fields.assignChildren(current, skip_node, nlohmann::json::parse(scratch));
+                  } catch (const nlohmann::json::parse_error&) {
+                      fail("malformed object");
+                      return i;
+                  }
+              }
+              fields.assign(current, value_slot, SearchFields::ValueKind::Raw, scratch);
+          }
+          endValue();
+          return i;
+      }
+  }
+  if (capturing) scratch.append(data, i);
+  return i;
+}
+
+static bool isJsonSpace(char c) {
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+bool SearchStreamParser::feed(const char* data, size_t length) {
+  size_t i = 0;
+  while (i < length) {
+      const char c = data[i];
+      switch (state) {
+          case State::Error:
+              return false;
+
+          case State::Skip:
+              i += skip(data + i, length - i);
+              break;
+
+          case State::String: {
+              // copy the plain run up to the next quote or backslash in one go
+              size_t end = i;
+              while (end < length && data[end] != '"' && data[end] != '\\') ++end;
+              // only another \u escape may follow a high surrogate
+              if (high_surrogate && (end > i || (end < length && data[end] == '"'))) {
+                  return fail("unpaired surrogate");
+              }
+              if (capturing) scratch.append(data + i, end - i);
+              i = end;
+              if (i == length) break;
+              if (data[i] == '\\') {
+                  state = State::Escape;
+              } else {
+                  endString();
+              }
+              ++i;
+              break;
+          }
+
+          case State::Escape: {
+              char unescaped = 0;
+              if (high_surrogate && c != 'u') return fail("unpaired surrogate");
+              switch (c) {
+                  case '"': unescaped = '"'; break;
+                  case '\\': unescaped = '\\'; break;
+                  case '/': unescaped = '/'; break;
+                  case 'b': unescaped = '\b'; break;
+                  case 'f': unescaped = '\f'; break;
+                  case 'n': unescaped = '\n'; break;
+                  case 'r': unescaped = '\r'; break;
+                  case 't': unescaped = '\t'; break;
+                  case 'u':
+                      unicode_value = 0;
+                      unicode_digits = 0;
+                      state = State::Unicode;
+                      break;
+                  default:
+                      return fail("invalid escape");
+              }
+              if (state == State::Escape) {
+                  if (capturing) scratch += unescaped;
+                  state = State::String;
+              }
+              ++i;
+              break;
+          }
+
+          case State::Unicode: {
+              unsigned digit;
+              if (c >= '0' && c <= '9') digit = static_cast<unsigned>(c - '0');
+              else if (c >= 'a' && c <= 'f') digit = static_cast<unsigned>(c - 'a' + 10);
+              else if (c >= 'A' && c <= 'F') digit = static_cast<unsigned>(c - 'A' + 10);
+              else return fail("invalid \\u escape");
+              unicode_value = unicode_value * 16 + digit;
+              if (++unicode_digits == 4) {
+                  if (!appendCodepoint(unicode_value)) return false;
+                  state = State::String;
+              }
+              ++i;
+              break;
+          }
+
+          case State::Literal:
+              if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || c == '-' || c == '+' || c == '.' ||
+                  c == 'E') {
+                  scratch += c;
+                  ++i;
+              } else if (!endLiteral()) {
+                  return false;
+              }
+              // the delimiter is handled by the next state
+              break;
+
+          case State::Value:
+          case State::ArrayStart:
+              if (isJsonSpace(c)) {
+                  ++i;
+              } else if (c == ']' && state == State::ArrayStart) {
+                  endContainer('[');
+                  ++i;
+              } else if (c == '{' || c == '[' || c == '"') {
+                  beginValue(c);
+                  ++i;
+              } else if (c == '-' || (c >= '0' && c <= '9') || c == 't' || c == 'f' || c == 'n') {
+                  beginValue(c);
+              } else {
+                  return fail("expected a value");
+              }
+              break;
+
+          case State::ObjectStart:
+          case State::ObjectKey:
+              if (isJsonSpace(c)) {
+                  ++i;
+              } else if (c == '"') {
+                  beginString(true, true);
+                  ++i;
+              } else if (c == '}' && state == State::ObjectStart) {
+                  endContainer('{');
+                  ++i;
+              } else {
+                  return fail("expected an object key");
+              }
+              break;
+
+          case State::Colon:
+              if (isJsonSpace(c)) {
+                  ++i;
+              } else if (c == ':') {
+                  state = State::Value;
+                  ++i;
+              } else {
+                  return fail("expected ':'");
+              }
+              break;
+
+          case State::AfterValue:
+              if (isJsonSpace(c)) {
+                  ++i;
+              } else if (c == ',') {
+                  state = stack.back().type == '{' ? State::ObjectKey : State::Value;
+                  ++i;
+              } else if (c == '}' || c == ']') {
+                  endContainer(c == '}' ? '{' : '[');
+                  ++i;
+              } else {
+                  return fail("expected ',' or a closing bracket");
+              }
+              break;
+
+          case State::Done:
+              if (!isJsonSpace(c)) return fail("trailing data after the document");
+              ++i;
+              break;
+      }
+  }
+  return state != State::Error;
+}
+
+bool SearchStreamParser::finish() {
+  // a bare number at the top level only ends with the input
+  if (state == State::Literal && stack.empty() && !endLiteral()) return false;
+  if (state == State::Error) return false;
+  if (state != State::Done) return fail("unexpected end of input");
+  return true;
+}
@@ -0,0 +1,108 @@
+#ifndef SEARCH_STREAM_PARSER_H
+#define SEARCH_STREAM_PARSER_H
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "project_info.h"
+#include "search_fields.h"
+
+// Push parser for /search/repositories responses. The body is fed chunk by
+// chunk as libcurl delivers it and each entry of "items" is turned into a
+// ProjectInfo the moment its closing brace arrives, so parsing overlaps the
+// transfer and no DOM of the page is ever built.
+//
+// Only the path down to the requested fields is tokenized. Every other value
+// (the owner object, the *_url fields, topics, ...) is stepped over by
+// counting brackets outside of strings, without decoding or copying it.
+class SearchStreamParser {
+public:
+    using ItemCallback = std::function<void(ProjectInfo&&)>;
+
+    // Items go to on_item when given, otherwise they are collected in projects().
+    explicit SearchStreamParser(const SearchFields& fields = SearchFields(), ItemCallback on_item = nullptr);
+
+    // Forget everything parsed so far, e.g. before a retried request.
+    void reset();
+
+    // Parse the next chunk of the body. False once the tokenized path isn't
+    // valid JSON; skipped values are only bracket-matched, so callers fall back
+    // to json.hpp when this or finish() fails rather than trusting it to reject
+    // every malformed document.
+    bool feed(const char* data, size_t length);
+
+    // True when exactly one complete JSON document was fed.
+    bool finish();
+
+    bool failed() const { return state == State::Error; }
+    const std::string& error() const { return error_message; }
+
+    // Whether the document had a top-level "items" array at all.
+    bool sawItems() const { return saw_items; }
+    size_t itemCount() const { return item_count; }
+    std::vector<ProjectInfo>& projects() { return collected; }
+
+private:
+    enum class State {
+        Value,          // any value
+        ArrayStart,     // a value or ']'
+        ObjectStart,    // a key or '}'
+        ObjectKey,      // a key, after ','
+        Colon,
+        String,
+        Escape,
+        Unicode,
+        Literal,        // number, true, false, null
+        Skip,           // inside an object or array nobody asked for
+        AfterValue,     // ',' or a closing bracket
+        Done,
+        Error
+    };
+
+    // containers that are tokenized; everything else is skipped
+    enum class Frame { Root, Items, Node };
+
+    struct Level {
+        char type;     // '{' or '['
+        Frame frame;
+        int node;      // Node: position in the field trie
+        int pending;   // objects: what the value after the current key is
+    };
+
+    static const int NONE = -1;
+    static const int ITEMS = -2;  // Root's "items"
+
+    int valueTarget() const;
+    void beginValue(char c);
+    void endContainer(char type);
+    void beginString(bool key, bool capture);
+    void endString();
+    bool endLiteral();
+    void endValue();
+    bool appendCodepoint(unsigned code);
+    size_t skip(const char* data, size_t length);
+    bool fail(const char* message);
+
+    SearchFields fields;
+    ItemCallback on_item;
+    std::vector<ProjectInfo> collected;
+    ProjectInfo current;
+    std::vector<Level> stack;
+    State state = State::Value;
+    std::string scratch;       // current key or kept value
+    bool string_is_key = false;
+    bool capturing = false;
+    int value_slot = NONE;     // field the current scalar or skipped value is stored in
+    unsigned unicode_value = 0;
+    int unicode_digits = 0;
+    unsigned high_surrogate = 0;  // a \uD800-\uDBFF waiting for its low half
+    int skip_node = NONE;      // trie node of the skipped value
+    int skip_depth = 0;
+    bool skip_in_string = false;
+    bool skip_escape = false;
+    bool saw_items = false;
+    size_t item_count = 0;
+    std::string error_message;
+};
+
+#endif
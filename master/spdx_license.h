@@ -0,0 +1,44 @@
+#ifndef SPDX_LICENSE_H
+#define SPDX_LICENSE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+
+// license.spdx_id as an index into SPDX_LICENSES, so a record spends one byte
+// on it and filters compare integers. The first three entries aren't ids: no
+// license at all, GitHub's "NOASSERTION" (a license file it couldn't
+// identify) and an id this table doesn't know.
+enum class SpdxLicense : std::uint8_t { Unknown = 0, NoAssertion = 1, Other = 2 };
+
+// Display names of the above, then every id GitHub's licenses API reports,
+// sorted for binary search.
+inline constexpr std::string_view SPDX_LICENSES[] = {
+    "Unknown", "No license", "Other",
+    "0BSD", "AFL-3.0", "AGPL-3.0", "Apache-2.0", "Artistic-2.0", "BSD-2-Clause", "BSD-2-Clause-Patent",
+    "BSD-3-Clause", "BSD-3-Clause-Clear", "BSD-4-Clause", "BSL-1.0", "CC-BY-4.0", "CC-BY-SA-4.0", "CC0-1.0",
+    "CECILL-2.1", "CERN-OHL-P-2.0", "CERN-OHL-S-2.0", "CERN-OHL-W-2.0", "ECL-2.0", "EPL-1.0", "EPL-2.0",
+    "EUPL-1.1", "EUPL-1.2", "GFDL-1.3", "GPL-2.0", "GPL-3.0", "ISC", "LGPL-2.1", "LGPL-3.0", "LPPL-1.3c",
+    "MIT", "MIT-0", "MPL-2.0", "MS-PL", "MS-RL", "MulanPSL-2.0", "NCSA", "ODbL-1.0", "OFL-1.1", "OSL-3.0",
+    "PostgreSQL", "UPL-1.0", "Unlicense", "Vim", "WTFPL", "Zlib"
+};
+inline constexpr size_t SPDX_FIRST_ID = 3;
+
+// The license for a spdx_id string; Other when it isn't in the table.
+inline SpdxLicense spdxLicense(std::string_view spdx_id) {
+    if (spdx_id == "NOASSERTION") return SpdxLicense::NoAssertion;
+    const std::string_view* first = std::begin(SPDX_LICENSES) + SPDX_FIRST_ID;
+    const std::string_view* found = std::lower_bound(first, std::end(SPDX_LICENSES), spdx_id);
+    if (found == std::end(SPDX_LICENSES) || *found != spdx_id) return SpdxLicense::Other;
+    return static_cast<SpdxLicense>(found - std::begin(SPDX_LICENSES));
+}
+
+// "MIT", "No license", "Unknown"... as the CLI prints them.
+inline std::string_view spdxName(SpdxLicense license) {
+    const size_t index = static_cast<size_t>(license);
+    return index < std::size(SPDX_LICENSES) ? SPDX_LICENSES[index] : SPDX_LICENSES[0];
+}
+
+#endif
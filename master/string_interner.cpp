@@ -0,0 +1,52 @@
+#include "string_interner.h"
+#include <cstring>
+#include <functional>
+
+StringInterner& StringInterner::global() {
+  static StringInterner interner;
+  return interner;
+}
+
+const char* StringInterner::Shard::store(std::string_view value) {
+  if (value.size() > BLOCK_SIZE / 4) {
+      // long values get an allocation of their own instead of wasting the rest of a block
+      large.emplace_back(new char[value.size()]);
+      std::memcpy(large.back().get(), value.data(), value.size());
+      return large.back().get();
+  }
+  if (BLOCK_SIZE - block_used < value.size()) {
+      blocks.emplace_back(new char[BLOCK_SIZE]);
+      block_used = 0;
+  }
+  char* copy = blocks.back().get() + block_used;
+  std::memcpy(copy, value.data(), value.size());
+  block_used += value.size();
+  return copy;
+}
+
+std::string_view StringInterner::intern(std::string_view value) {
+  if (value.empty()) return std::string_view();
+  const size_t hash = std::hash<std::string_view>()(value);
+  Shard& shard = shards[(hash >> 8) % SHARDS];  // low bits pick the bucket inside the shard
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  ++shard.lookups;
+  shard.requested_bytes += value.size();
+  auto found = shard.values.find(value);
+  if (found != shard.values.end()) return *found;
+  const std::string_view stored(shard.store(value), value.size());
+  shard.values.insert(stored);
+  shard.stored_bytes += value.size();
+  return stored;
+}
+
+StringInterner::Stats StringInterner::stats() const {
+  Stats total{0, 0, 0, 0};
+  for (const Shard& shard : shards) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      total.strings += shard.values.size();
+      total.stored_bytes += shard.stored_bytes;
+      total.lookups += shard.lookups;
+      total.requested_bytes += shard.requested_bytes;
+  }
+  return total;
+}
@@ -0,0 +1,62 @@
+#ifndef STRING_INTERNER_H
+#define STRING_INTERNER_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+// One copy of each distinct string, for field values that repeat across a
+// crawl (owner logins, languages, license names). intern() returns a view of
+// that copy; it stays valid as long as the interner, so two interned values
+// are equal exactly when their data pointers are. Sharded by hash, each shard
+// with its own lock and its own blocks of storage, so parsing threads rarely
+// wait on each other. Nothing is ever removed. Thread-safe.
+class StringInterner {
+public:
+    struct Stats {
+        size_t strings;                         // distinct values stored
+        size_t stored_bytes;                    // their characters
+        unsigned long long lookups;             // intern() calls
+        unsigned long long requested_bytes;     // characters passed to intern()
+        // what copying every value would have cost beyond storing each once
+        long long savedBytes() const { return static_cast<long long>(requested_bytes) - static_cast<long long>(stored_bytes); }
+    };
+
+    StringInterner() = default;
+    StringInterner(const StringInterner&) = delete;
+    StringInterner& operator=(const StringInterner&) = delete;
+
+    // Interner shared by every ProjectTable and TableFilter that isn't handed one.
+    static StringInterner& global();
+
+    std::string_view intern(std::string_view value);
+
+    // Both interned here (or both empty): a pointer compare.
+    static bool same(std::string_view a, std::string_view b) { return a.data() == b.data() && a.size() == b.size(); }
+
+    Stats stats() const;
+
+private:
+    static constexpr size_t SHARDS = 16;
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_set<std::string_view> values;
+        std::vector<std::unique_ptr<char[]>> blocks;
+        std::vector<std::unique_ptr<char[]>> large;
+        size_t block_used = BLOCK_SIZE;  // of blocks.back(); full until the first one exists
+        size_t stored_bytes = 0;
+        unsigned long long lookups = 0;
+        unsigned long long requested_bytes = 0;
+
+        const char* store(std::string_view value);
+    };
+
+    Shard shards[SHARDS];
+};
+
+#endif
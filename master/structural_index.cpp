@@ -0,0 +1,188 @@
+#include "structural_index.h"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define STRUCTURAL_INDEX_X86 1
+#endif
+
+namespace {
+
+struct BlockMasks {
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t structural;  // { } [ ] : ,
+};
+
+void classifyScalar(const unsigned char* block, BlockMasks& masks) {
+  masks = BlockMasks{0, 0, 0};
+  for (int i = 0; i < 64; ++i) {
+      const uint64_t bit = 1ULL << i;
+      switch (block[i]) {
+          case '"': masks.quote |= bit; break;
+          case '\\': masks.backslash |= bit; break;
+          case '{': case '}': case '[': case ']': case ':': case ',':
+              masks.structural |= bit;
+              break;
+          default: break;
+      }
+  }
+}
+
+#ifdef STRUCTURAL_INDEX_X86
+// '{' / '[' and '}' / ']' differ only in bit 0x20, so two compares cover all four brackets
+__attribute__((target("sse2")))
+void classifySse2(const unsigned char* block, BlockMasks& masks) {
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i open = _mm_set1_epi8('{');
+  const __m128i close = _mm_set1_epi8('}');
+  const __m128i colon = _mm_set1_epi8(':');
+  const __m128i comma = _mm_set1_epi8(',');
+  const __m128i case_bit = _mm_set1_epi8(0x20);
+  masks = BlockMasks{0, 0, 0};
+  for (int i = 0; i < 4; ++i) {
+      const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * i));
+      const __m128i folded = _mm_or_si128(v, case_bit);
+      const __m128i structural = _mm_or_si128(
+          _mm_or_si128(_mm_cmpeq_epi8(folded, open), _mm_cmpeq_epi8(folded, close)),
+          _mm_or_si128(_mm_cmpeq_epi8(v, colon), _mm_cmpeq_epi8(v, comma)));
+      const int shift = 16 * i;
+      masks.quote |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, quote)))) << shift;
+      masks.backslash |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, backslash)))) << shift;
+      masks.structural |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(structural))) << shift;
+  }
+}
+
+__attribute__((target("avx2")))
+void classifyAvx2(const unsigned char* block, BlockMasks& masks) {
+  const __m256i quote = _mm256_set1_epi8('"');
+  const __m256i backslash = _mm256_set1_epi8('\\');
+  const __m256i open = _mm256_set1_epi8('{');
+  const __m256i close = _mm256_set1_epi8('}');
+  const __m256i colon = _mm256_set1_epi8(':');
+  const __m256i comma = _mm256_set1_epi8(',');
+  const __m256i case_bit = _mm256_set1_epi8(0x20);
+  masks = BlockMasks{0, 0, 0};
+  for (int i = 0; i < 2; ++i) {
+      const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32 * i));
+      const __m256i folded = _mm256_or_si256(v, case_bit);
+      const __m256i structural = _mm256_or_si256(
+          _mm256_or_si256(_mm256_cmpeq_epi8(folded, open), _mm256_cmpeq_epi8(folded, close)),
+          _mm256_or_si256(_mm256_cmpeq_epi8(v, colon), _mm256_cmpeq_epi8(v, comma)));
+      const int shift = 32 * i;
+      masks.quote |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, quote)))) << shift;
+      masks.backslash |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, backslash)))) << shift;
+      masks.structural |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(structural))) << shift;
+  }
+}
+#endif
+
+// Characters escaped by a backslash, given the backslashes of this block and
+// whether the first character of it is escaped by the previous one (runs of
+// backslashes escape every other character).
+inline uint64_t findEscaped(uint64_t backslash, uint64_t& prev_escaped) {
+  backslash &= ~prev_escaped;
+  const uint64_t follows_escape = backslash << 1 | prev_escaped;
+  const uint64_t even_bits = 0x5555555555555555ULL;
+  const uint64_t odd_sequence_starts = backslash & ~even_bits & ~follows_escape;
+  uint64_t sequences_starting_on_even_bits = odd_sequence_starts + backslash;
+  prev_escaped = sequences_starting_on_even_bits < odd_sequence_starts ? 1 : 0;
+  const uint64_t invert_mask = sequences_starting_on_even_bits << 1;
+  return (even_bits ^ invert_mask) & follows_escape;
+}
+
+// bit i = XOR of bits 0..i: set from an opening quote up to its closing one
+inline uint64_t prefixXor(uint64_t bits) {
+  bits ^= bits << 1;
+  bits ^= bits << 2;
+  bits ^= bits << 4;
+  bits ^= bits << 8;
+  bits ^= bits << 16;
+  bits ^= bits << 32;
+  return bits;
+}
+
+inline int trailingZeros(uint64_t bits) {
+#if defined(__GNUC__)
+  return __builtin_ctzll(bits);
+#else
+  int n = 0;
+  while (!(bits & 1)) {
+      bits >>= 1;
+      ++n;
+  }
+  return n;
+#endif
+}
+
+}  // namespace
+
+bool StructuralIndex::supported(Isa isa) {
+#if defined(STRUCTURAL_INDEX_X86) && defined(__GNUC__)
+  switch (isa) {
+      case Isa::Scalar: return true;
+      case Isa::Sse2: return __builtin_cpu_supports("sse2");
+      case Isa::Avx2: return __builtin_cpu_supports("avx2");
+  }
+  return false;
+#else
+  return isa == Isa::Scalar;
+#endif
+}
+
+StructuralIndex::Isa StructuralIndex::bestIsa() {
+  static const Isa best = supported(Isa::Avx2) ? Isa::Avx2 : supported(Isa::Sse2) ? Isa::Sse2 : Isa::Scalar;
+  return best;
+}
+
+const char* StructuralIndex::name(Isa isa) {
+  switch (isa) {
+      case Isa::Scalar: return "scalar";
+      case Isa::Sse2: return "sse2";
+      case Isa::Avx2: return "avx2";
+  }
+  return "?";
+}
+
+bool StructuralIndex::build(const char* data, size_t length, Isa isa) {
+  void (*classify)(const unsigned char*, BlockMasks&) = classifyScalar;
+#ifdef STRUCTURAL_INDEX_X86
+  if (isa == Isa::Avx2 && supported(Isa::Avx2)) classify = classifyAvx2;
+  else if (isa == Isa::Sse2 && supported(Isa::Sse2)) classify = classifySse2;
+#else
+  (void)isa;
+#endif
+
+  structurals.clear();
+  // roughly one structural every 6 bytes in API responses
+  structurals.reserve(length / 6 + 16);
+
+  const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+  unsigned char tail[64];
+  uint64_t prev_escaped = 0;
+  uint64_t prev_in_string = 0;
+  BlockMasks masks;
+  for (size_t base = 0; base < length; base += 64) {
+      const unsigned char* block = bytes + base;
+      if (length - base < 64) {
+          // pad the last block with spaces, which are never structural
+          std::memset(tail, ' ', sizeof(tail));
+          std::memcpy(tail, block, length - base);
+          block = tail;
+      }
+      classify(block, masks);
+
+      const uint64_t escaped = findEscaped(masks.backslash, prev_escaped);
+      const uint64_t quotes = masks.quote & ~escaped;
+      const uint64_t in_string = prefixXor(quotes) ^ prev_in_string;
+      prev_in_string = static_cast<uint64_t>(static_cast<int64_t>(in_string) >> 63);
+
+      uint64_t bits = (masks.structural & ~in_string) | quotes;
+      while (bits) {
+          structurals.push_back(static_cast<uint32_t>(base + static_cast<size_t>(trailingZeros(bits))));
+          bits &= bits - 1;
+      }
+  }
+  return prev_in_string == 0;
+}
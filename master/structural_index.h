@@ -0,0 +1,32 @@
+#ifndef STRUCTURAL_INDEX_H
+#define STRUCTURAL_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Positions of the structural characters of a JSON document: every unescaped
+// quote, and { } [ ] : , outside of strings. The document is classified 64
+// bytes at a time into bitmasks (SSE2 or AVX2 compares where the CPU has
+// them, a byte loop otherwise), escapes and string interiors are resolved with
+// carry-propagating bit tricks, and the surviving bits become positions. A
+// parser can then hop from token to token instead of looking at every byte.
+class StructuralIndex {
+public:
+    enum class Isa { Scalar, Sse2, Avx2 };
+
+    // Widest instruction set this CPU supports, decided once at runtime.
+    static Isa bestIsa();
+    static bool supported(Isa isa);
+    static const char* name(Isa isa);
+
+    // Index data[0, length). False when the document ends inside a string.
+    bool build(const char* data, size_t length, Isa isa = bestIsa());
+
+    const std::vector<uint32_t>& positions() const { return structurals; }
+
+private:
+    std::vector<uint32_t> structurals;
+};
+
+#endif
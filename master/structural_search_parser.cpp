@@ -0,0 +1,235 @@
+#include "structural_search_parser.h"
+#include <cstring>
+#include "json_text.h"
+
+static bool isBlank(const char* begin, const char* end) {
+  for (const char* p = begin; p < end; ++p) {
+      if (*p != ' ' && *p != '\n' && *p != '\r' && *p != '\t') return false;
+  }
+  return true;
+}
+
+StructuralSearchParser::StructuralSearchParser(const SearchFields& fields, StructuralIndex::Isa isa)
+    : fields(fields), isa(isa) {}
+
+bool StructuralSearchParser::fail(const char* message) {
+  error_message = message;
+  return false;
+}
+
+bool StructuralSearchParser::parse(const std::string& body, std::vector<ProjectInfo>& projects_out) {
+  writable = nullptr;
+  items.clear();
+  if (!run(body.data(), body.size())) return false;
+  projects_out.insert(projects_out.end(), std::make_move_iterator(items.begin()),
+                      std::make_move_iterator(items.end()));
+  items.clear();
+  return true;
+}
+
+bool StructuralSearchParser::parse(const std::string& body, std::pmr::vector<ProjectInfo>& projects_out) {
+  writable = nullptr;
+  arena_items = &projects_out;
+  const size_t start = projects_out.size();
+  const bool parsed = run(body.data(), body.size());
+  arena_items = nullptr;
+  if (!parsed) projects_out.erase(projects_out.begin() + static_cast<std::ptrdiff_t>(start), projects_out.end());
+  return parsed;
+}
+
+bool StructuralSearchParser::parseInPlace(std::string& body, std::vector<ProjectInfoView>& views_out) {
+  view_items.clear();
+  if (fields.hasNestedRequests()) {
+      saw_items = false;
+      return fail("nested field requests can't be viewed");
+  }
+  writable = &body[0];
+  const bool parsed = run(body.data(), body.size());
+  writable = nullptr;
+  if (!parsed) return false;
+  views_out.insert(views_out.end(), std::make_move_iterator(view_items.begin()),
+                   std::make_move_iterator(view_items.end()));
+  view_items.clear();
+  return true;
+}
+
+bool StructuralSearchParser::run(const char* body, size_t body_length) {
+  saw_items = false;
+  error_message.clear();
+  data = body;
+  length = body_length;
+  if (!structural_index.build(data, length, isa)) return fail("unterminated string");
+  positions = structural_index.positions().data();
+  count = structural_index.positions().size();
+  next = 0;
+
+  if (count == 0 || !isBlank(data, data + positions[0])) return fail("expected an object or array");
+  if (!value(ROOT)) return false;
+  if (next != count || !isBlank(data + positions[count - 1] + 1, data + length)) {
+      return fail("trailing data after the document");
+  }
+  return true;
+}
+
+// target: ROOT, ITEMS, a node of the field trie, or NONE
+bool StructuralSearchParser::value(int target) {
+  if (next >= count) return fail("unexpected end of input");
+  const char c = token();
+  if (c == '{') return object(target);
+  if (c == '[') return target == ITEMS ? array() : skip(target);
+
+  const int slot = target >= 0 ? fields.node(target).slot : NONE;
+  if (c == '"') {
+      if (next + 1 >= count || data[positions[next + 1]] != '"') return fail("unterminated string");
+      const char* begin = data + positions[next] + 1;
+      const char* end = data + positions[next + 1];
+      next += 2;
+      return slot == NONE || storeString(slot, begin, end);
+  }
+  return literal(slot);
+}
+
+bool StructuralSearchParser::storeString(int slot, const char* begin, const char* end) {
+  const bool escaped = std::memchr(begin, '\\', static_cast<size_t>(end - begin)) != nullptr;
+  if (writable) {
+      char* first = writable + (begin - data);
+      char* last = first + (end - begin);
+      if (escaped && !(last = unescapeJsonInPlace(first, last))) return fail("invalid escape");
+      fields.assign(current_view, slot, SearchFields::ValueKind::String,
+                    std::string_view(first, static_cast<size_t>(last - first)));
+      return true;
+  }
+  if (!escaped) {
+      fields.assign(*current, slot, SearchFields::ValueKind::String,
+                    std::string_view(begin, static_cast<size_t>(end - begin)));
+      return true;
+  }
+  if (!unescapeJson(begin, end, text)) return fail("invalid escape");
+  fields.assign(*current, slot, SearchFields::ValueKind::String, text);
+  return true;
+}
+
+// a number/true/false/null has no structural of its own: it is whatever sits
+// between the previous structural and the current one
+bool StructuralSearchParser::literal(int slot) {
+  const char* begin = data + (next == 0 ? 0 : positions[next - 1] + 1);
+  const char* end = data + positions[next];
+  while (begin < end && (*begin == ' ' || *begin == '\n' || *begin == '\r' || *begin == '\t')) ++begin;
+  while (end > begin && (end[-1] == ' ' || end[-1] == '\n' || end[-1] == '\r' || end[-1] == '\t')) --end;
+  const std::string_view literal_text(begin, static_cast<size_t>(end - begin));
+  if (!isJsonLiteral(literal_text)) return fail("invalid literal");
+  if (slot == NONE) return true;
+  if (writable) {
+      fields.assign(current_view, slot, SearchFields::ValueKind::Literal, literal_text);
+  } else {
+      fields.assign(*current, slot, SearchFields::ValueKind::Literal, literal_text);
+  }
+  return true;
+}
+
+bool StructuralSearchParser::object(int target) {
+  const bool walk = target == ROOT || target == 0 ||
+                    (target > 0 && fields.node(target).slot == NONE && !fields.node(target).children.empty());
+  if (!walk) return skip(target);
+  if (target == 0) {
+      if (writable) {
+          current_view = fields.blankView();
+      } else if (arena_items) {
+          // built in place: assigning would copy it out of the arena
+          arena_items->push_back(fields.blank(arena_items->get_allocator()));
+          current = &arena_items->back();
+      } else {
+          items.push_back(fields.blank());
+          current = &items.back();
+      }
+  }
+
+  ++next;  // '{'
+  if (next < count && token() == '}') {
+      ++next;
+  } else {
+      for (;;) {
+          if (next + 2 >= count || token() != '"' || data[positions[next + 1]] != '"' ||
+              data[positions[next + 2]] != ':') {
+              return fail("expected an object key");
+          }
+          const char* begin = data + positions[next] + 1;
+          const char* end = data + positions[next + 1];
+          if (std::memchr(begin, '\\', static_cast<size_t>(end - begin))) {
+              if (!unescapeJson(begin, end, text)) return fail("invalid escape");
+          } else {
+              text.assign(begin, end);
+          }
+          const int child = target == ROOT ? (text == "items" ? ITEMS : NONE) : fields.child(target, text);
+          next += 3;
+          if (!value(child)) return false;
+          if (next >= count) return fail("unexpected end of input");
+          const char c = token();
+          ++next;
+          if (c == '}') break;
+          if (c != ',') return fail("expected ',' or '}'");
+      }
+  }
+  if (target == 0) {
+      if (writable) view_items.push_back(std::move(current_view));
+  }
+  return true;
+}
+
+bool StructuralSearchParser::array() {
+  saw_items = true;
+  ++next;  // '['
+  if (next < count && token() == ']') {
+      ++next;
+      return true;
+  }
+  for (;;) {
+      if (!value(0)) return false;
+      if (next >= count) return fail("unexpected end of input");
+      const char c = token();
+      ++next;
+      if (c == ']') return true;
+      if (c != ',') return fail("expected ',' or ']'");
+  }
+}
+
+// step over an object/array nobody asked for, or keep its raw text when the
+// whole value was requested
+bool StructuralSearchParser::skip(int target) {
+  const size_t start = positions[next];
+  int depth = 0;
+  for (; next < count; ++next) {
+      const char c = token();
+      if (c == '{' || c == '[') {
+          ++depth;
+      } else if ((c == '}' || c == ']') && --depth == 0) {
+          break;
+      }
+  }
+  if (next >= count) return fail("unterminated object or array");
+  const size_t end = positions[next] + 1;
+  ++next;
+
+  const int slot = target >= 0 ? fields.node(target).slot : NONE;
+  if (slot == NONE) return true;
+  if (writable) {
+      // nested requests were turned away up front, so there are no members to decode
+      fields.assign(current_view, slot, SearchFields::ValueKind::Raw, std::string_view(data + start, end - start));
+      return true;
+  }
+  if (!fields.node(target).children.empty()) {
+      // members were asked for too; rare enough to go through the DOM
+      try {
+          if (arena_items) {
+              PageArena::Scope scope(arena_items->get_allocator().resource());
+              fields.assignChildren(*current, target, ArenaJson::parse(data + start, data + end));
+          } else {
+              fields.assignChildren(*current, target, nlohmann::json::parse(data + start, data + end));
+          }
+      } catch (const nlohmann::json::parse_error&) {
+          return fail("malformed object");
+      }
+  }
+  fields.assign(*current, slot, SearchFields::ValueKind::Raw, std::string_view(data + start, end - start));
+  return true;
+}
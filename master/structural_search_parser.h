@@ -0,0 +1,72 @@
+#ifndef STRUCTURAL_SEARCH_PARSER_H
+#define STRUCTURAL_SEARCH_PARSER_H
+
+#include <string>
+#include <vector>
+#include "project_info.h"
+#include "search_fields.h"
+#include "structural_index.h"
+
+// Extracts search items from a complete response body by walking its
+// StructuralIndex: keys and values are sliced straight out of the body
+// between quote positions, and unrequested objects are skipped by counting
+// brackets in the index rather than bytes. Checks less than a full parser
+// does; callers fall back to json.hpp when parse() returns false.
+class StructuralSearchParser {
+public:
+    explicit StructuralSearchParser(const SearchFields& fields = SearchFields(),
+                                    StructuralIndex::Isa isa = StructuralIndex::bestIsa());
+
+    // Append the items of body to projects_out. False (and nothing appended)
+    // when body isn't a well-formed document.
+    bool parse(const std::string& body, std::vector<ProjectInfo>& projects_out);
+    // Into a vector on an arena: every item and string comes from its resource.
+    // False (and nothing left appended) when body isn't a well-formed document.
+    bool parse(const std::string& body, std::pmr::vector<ProjectInfo>& projects_out);
+
+    // Same without copying: strings are decoded in place in body and the views
+    // appended to views_out point into it, so body has to outlive them. On
+    // failure body may be left partly decoded. Fails for field sets with
+    // nested requests (SearchFields::hasNestedRequests).
+    bool parseInPlace(std::string& body, std::vector<ProjectInfoView>& views_out);
+
+    const SearchFields& getFields() const { return fields; }
+    bool sawItems() const { return saw_items; }
+    const std::string& error() const { return error_message; }
+    const StructuralIndex& index() const { return structural_index; }
+
+private:
+    static const int NONE = -1;
+    static const int ITEMS = -2;
+    static const int ROOT = -3;
+
+    bool run(const char* body, size_t body_length);
+    bool value(int target);
+    bool object(int target);
+    bool array();
+    bool skip(int target);
+    bool literal(int slot);
+    bool storeString(int slot, const char* begin, const char* end);
+    bool fail(const char* message);
+    char token() const { return data[positions[next]]; }
+
+    SearchFields fields;
+    StructuralIndex::Isa isa;
+    StructuralIndex structural_index;
+    const char* data = nullptr;
+    char* writable = nullptr;   // same as data while parsing in place
+    size_t length = 0;
+    const uint32_t* positions = nullptr;
+    size_t count = 0;
+    size_t next = 0;            // index of the next unread structural
+    ProjectInfo* current = nullptr;   // the item being filled, in items or arena_items
+    std::vector<ProjectInfo> items;
+    std::pmr::vector<ProjectInfo>* arena_items = nullptr;
+    ProjectInfoView current_view;
+    std::vector<ProjectInfoView> view_items;
+    std::string text;
+    bool saw_items = false;
+    std::string error_message;
+};
+
+#endif
@@ -0,0 +1,364 @@
+#include "table_filter.h"
+#include <algorithm>
+#include <cctype>
+#include <ctime>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include "iso_time.h"
+#include "search_fields.h"
+#include "spdx_license.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define TABLE_FILTER_X86 1
+#endif
+
+namespace {
+
+// words[w] &= rows of values[64w, 64w + 64) within [lo, hi]; one unsigned
+// compare per row (values below lo wrap around to above the span)
+template <typename T>
+void rangeScalar(const T* values, size_t rows, T lo, T hi, uint64_t* words) {
+  using U = std::make_unsigned_t<T>;
+  const U span = static_cast<U>(static_cast<U>(hi) - static_cast<U>(lo));
+  for (size_t w = 0; w * 64 < rows; ++w) {
+      const T* block = values + w * 64;
+      const size_t count = std::min<size_t>(64, rows - w * 64);
+      uint64_t bits = 0;
+      for (size_t j = 0; j < count; ++j) {
+          bits |= static_cast<uint64_t>(static_cast<U>(static_cast<U>(block[j]) - static_cast<U>(lo)) <= span) << j;
+      }
+      words[w] &= bits;
+  }
+}
+
+void memberScalar(const uint8_t* values, size_t rows, const uint8_t* allowed, uint64_t* words) {
+  for (size_t w = 0; w * 64 < rows; ++w) {
+      const uint8_t* block = values + w * 64;
+      const size_t count = std::min<size_t>(64, rows - w * 64);
+      uint64_t bits = 0;
+      for (size_t j = 0; j < count; ++j) bits |= static_cast<uint64_t>(allowed[block[j]]) << j;
+      words[w] &= bits;
+  }
+}
+
+#ifdef TABLE_FILTER_X86
+// eight rows per compare; a row is out when lo > value or value > hi
+__attribute__((target("avx2")))
+void rangeAvx2(const int32_t* values, size_t rows, int32_t lo, int32_t hi, uint64_t* words) {
+  const __m256i low = _mm256_set1_epi32(lo);
+  const __m256i high = _mm256_set1_epi32(hi);
+  const size_t blocks = rows / 64;
+  for (size_t w = 0; w < blocks; ++w) {
+      uint64_t bits = 0;
+      for (int i = 0; i < 8; ++i) {
+          const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + w * 64 + 8 * i));
+          const __m256i out = _mm256_or_si256(_mm256_cmpgt_epi32(low, v), _mm256_cmpgt_epi32(v, high));
+          bits |= static_cast<uint64_t>(~_mm256_movemask_ps(_mm256_castsi256_ps(out)) & 0xFF) << (8 * i);
+      }
+      words[w] &= bits;
+  }
+  rangeScalar(values + blocks * 64, rows - blocks * 64, lo, hi, words + blocks);
+}
+
+// four rows per compare
+__attribute__((target("avx2")))
+void rangeAvx2(const int64_t* values, size_t rows, int64_t lo, int64_t hi, uint64_t* words) {
+  const __m256i low = _mm256_set1_epi64x(lo);
+  const __m256i high = _mm256_set1_epi64x(hi);
+  const size_t blocks = rows / 64;
+  for (size_t w = 0; w < blocks; ++w) {
+      uint64_t bits = 0;
+      for (int i = 0; i < 16; ++i) {
+          const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + w * 64 + 4 * i));
+          const __m256i out = _mm256_or_si256(_mm256_cmpgt_epi64(low, v), _mm256_cmpgt_epi64(v, high));
+          bits |= static_cast<uint64_t>(~_mm256_movemask_pd(_mm256_castsi256_pd(out)) & 0xF) << (4 * i);
+      }
+      words[w] &= bits;
+  }
+  rangeScalar(values + blocks * 64, rows - blocks * 64, lo, hi, words + blocks);
+}
+
+// 32 rows per lookup: allowed as a 16 x 8 bit matrix, one byte per low nibble
+// with a bit per high nibble, so two shuffles test a byte (ids are below 128)
+__attribute__((target("avx2")))
+void memberAvx2(const uint8_t* values, size_t rows, const uint8_t* allowed, uint64_t* words) {
+  alignas(16) uint8_t by_low[16] = {};
+  for (int id = 0; id < 128; ++id) {
+      if (allowed[id]) by_low[id & 15] |= static_cast<uint8_t>(1 << (id >> 4));
+  }
+  const __m256i matrix = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(by_low)));
+  const __m256i high_bit = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0,
+                                            1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0);
+  const __m256i nibble = _mm256_set1_epi8(0x0F);
+  const __m256i zero = _mm256_setzero_si256();
+  const size_t blocks = rows / 64;
+  for (size_t w = 0; w < blocks; ++w) {
+      uint64_t bits = 0;
+      for (int i = 0; i < 2; ++i) {
+          const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + w * 64 + 32 * i));
+          const __m256i row = _mm256_shuffle_epi8(matrix, _mm256_and_si256(v, nibble));
+          const __m256i bit = _mm256_shuffle_epi8(high_bit, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+          const __m256i miss = _mm256_cmpeq_epi8(_mm256_and_si256(row, bit), zero);
+          bits |= static_cast<uint64_t>(~static_cast<uint32_t>(_mm256_movemask_epi8(miss))) << (32 * i);
+      }
+      words[w] &= bits;
+  }
+  memberScalar(values + blocks * 64, rows - blocks * 64, allowed, words + blocks);
+}
+#endif
+
+// words[w] &= rows whose interned value is (or, with equal false, isn't) one of wanted
+void fieldScalar(const std::string_view* values, size_t rows, const std::vector<std::string_view>& wanted, bool equal,
+                 uint64_t* words) {
+  for (size_t w = 0; w * 64 < rows; ++w) {
+      const std::string_view* block = values + w * 64;
+      const size_t count = std::min<size_t>(64, rows - w * 64);
+      uint64_t bits = 0;
+      for (size_t j = 0; j < count; ++j) {
+          bool found = false;
+          for (std::string_view value : wanted) found |= StringInterner::same(block[j], value);
+          bits |= static_cast<uint64_t>(found == equal) << j;
+      }
+      words[w] &= bits;
+  }
+}
+
+template <typename T>
+void selectRange(const T* values, size_t rows, T lo, T hi, uint64_t* words, bool avx2) {
+#ifdef TABLE_FILTER_X86
+  if (avx2) {
+      rangeAvx2(values, rows, lo, hi, words);
+      return;
+  }
+#endif
+  (void)avx2;
+  rangeScalar(values, rows, lo, hi, words);
+}
+
+std::string trimmed(const std::string& text) {
+  const size_t first = text.find_first_not_of(" \t");
+  if (first == std::string::npos) return "";
+  return text.substr(first, text.find_last_not_of(" \t") - first + 1);
+}
+
+std::string lowercase(std::string text) {
+  for (char& c : text) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  return text;
+}
+
+// a license as written in a filter: an SPDX id in any case, or one of the pseudo-ids
+bool parseLicense(const std::string& name, SpdxLicense& license) {
+  const std::string lower = lowercase(name);
+  if (lower == "none" || lower == "unknown") {
+      license = SpdxLicense::Unknown;
+      return true;
+  }
+  if (lower == "noassertion") {
+      license = SpdxLicense::NoAssertion;
+      return true;
+  }
+  if (lower == "other") {
+      license = SpdxLicense::Other;
+      return true;
+  }
+  for (size_t i = SPDX_FIRST_ID; i < std::size(SPDX_LICENSES); ++i) {
+      if (lowercase(std::string(SPDX_LICENSES[i])) == lower) {
+          license = static_cast<SpdxLicense>(i);
+          return true;
+      }
+  }
+  return false;
+}
+
+// [first, last]: 2024-01-01 is the whole UTC day; a full timestamp, or 30d for
+// 30 days before now, is a single second
+bool parsePushed(const std::string& value, int64_t& first, int64_t& last) {
+  if (value.size() > 1 && value.size() <= 7 && value.back() == 'd' &&
+      value.find_first_not_of("0123456789") == value.size() - 1) {
+      first = last = static_cast<int64_t>(std::time(nullptr)) - std::stoll(value.substr(0, value.size() - 1)) * 86400;
+      return true;
+  }
+  if (value.size() == 10) {
+      if (!parseIsoTimestamp(value + "T00:00:00Z", first)) return false;
+      last = first + 86399;
+      return true;
+  }
+  if (!parseIsoTimestamp(value, first)) return false;
+  last = first;
+  return true;
+}
+
+// narrow [lo, hi] by "op value", where the value spans [first, last]: >= and <
+// compare with its start, <= and > with its end, = keeps rows inside it
+bool narrow(const std::string& op, int64_t first, int64_t last, int64_t& lo, int64_t& hi) {
+  const int64_t max = std::numeric_limits<int64_t>::max();
+  const int64_t min = std::numeric_limits<int64_t>::min();
+  if (op == "=") {
+      lo = std::max(lo, first);
+      hi = std::min(hi, last);
+  } else if (op == ">=") {
+      lo = std::max(lo, first);
+  } else if (op == ">") {
+      if (last == max) hi = min;  // nothing is greater
+      else lo = std::max(lo, last + 1);
+  } else if (op == "<=") {
+      hi = std::min(hi, last);
+  } else if (op == "<") {
+      if (first == min) lo = max;
+      else hi = std::min(hi, first - 1);
+  } else {
+      return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+bool TableFilter::parse(const std::string& text, TableFilter& filter, std::string& error, StringInterner& interner) {
+  filter = TableFilter();
+  std::istringstream conditions(text);
+  std::string condition;
+  while (std::getline(conditions, condition, ',')) {
+      condition = trimmed(condition);
+      if (condition.empty()) continue;
+      const size_t op_begin = condition.find_first_of("<>=!");
+      if (op_begin == std::string::npos || op_begin == 0) {
+          error = "expected column, operator and value in \"" + condition + "\"";
+          return false;
+      }
+      size_t op_end = op_begin + 1;
+      if (op_end < condition.size() && condition[op_end] == '=') ++op_end;
+      const std::string column = lowercase(trimmed(condition.substr(0, op_begin)));
+      const std::string op = condition.substr(op_begin, op_end - op_begin);
+      const std::string value = trimmed(condition.substr(op_end));
+      if (value.empty()) {
+          error = "missing value in \"" + condition + "\"";
+          return false;
+      }
+
+      if (column == "stars") {
+          int64_t stars = 0;
+          try {
+              size_t used = 0;
+              stars = std::stoll(value, &used);
+              if (used != value.size()) throw std::invalid_argument(value);
+          } catch (const std::exception&) {
+              error = "\"" + value + "\" is not a star count";
+              return false;
+          }
+          if (!narrow(op, stars, stars, filter.stars_min, filter.stars_max)) {
+              error = "stars can't be compared with " + op;
+              return false;
+          }
+          filter.filter_stars = true;
+      } else if (column == "pushed" || column == "pushed_at") {
+          int64_t pushed_first = 0, pushed_last = 0;
+          if (!parsePushed(value, pushed_first, pushed_last)) {
+              error = "\"" + value + "\" is not a date, timestamp or number of days";
+              return false;
+          }
+          if (!narrow(op, pushed_first, pushed_last, filter.pushed_min, filter.pushed_max)) {
+              error = "pushed can't be compared with " + op;
+              return false;
+          }
+          filter.filter_pushed = true;
+      } else if (column == "license") {
+          if (op != "=" && op != "!=") {
+              error = "license can only be compared with = or !=";
+              return false;
+          }
+          std::array<uint8_t, 256> listed{};
+          std::istringstream names(value);
+          std::string name;
+          while (std::getline(names, name, '|')) {
+              SpdxLicense license;
+              if (!parseLicense(trimmed(name), license)) {
+                  error = "unknown license \"" + trimmed(name) + "\"";
+                  return false;
+              }
+              listed[static_cast<size_t>(license)] = 1;
+          }
+          if (!filter.filter_license) filter.license_allowed.fill(1);
+          for (size_t i = 0; i < listed.size(); ++i) {
+              const uint8_t passes = op == "=" ? listed[i] : static_cast<uint8_t>(!listed[i]);
+              filter.license_allowed[i] &= passes;
+          }
+          filter.filter_license = true;
+      } else if (SearchFields::repeats(column)) {
+          if (op != "=" && op != "!=") {
+              error = column + " can only be compared with = or !=";
+              return false;
+          }
+          FieldCondition field;
+          field.path = column;
+          field.equal = op == "=";
+          std::istringstream values(value);
+          std::string item;
+          while (std::getline(values, item, '|')) field.values.push_back(interner.intern(trimmed(item)));
+          filter.fields.push_back(std::move(field));
+      } else {
+          error = "unknown column \"" + column + "\" (stars, pushed, license or a field such as language)";
+          return false;
+      }
+  }
+  return true;
+}
+
+bool TableFilter::avx2Available() {
+#if defined(TABLE_FILTER_X86) && defined(__GNUC__)
+  static const bool avx2 = __builtin_cpu_supports("avx2");
+  return avx2;
+#else
+  return false;
+#endif
+}
+
+std::vector<std::string> TableFilter::fieldPaths() const {
+  std::vector<std::string> paths;
+  for (const FieldCondition& field : fields) {
+      if (std::find(paths.begin(), paths.end(), field.path) == paths.end()) paths.push_back(field.path);
+  }
+  return paths;
+}
+
+Selection TableFilter::select(const ProjectTable& table, bool vectorized) const {
+  const size_t rows = table.size();
+  Selection selection(rows);
+  uint64_t* words = selection.words().data();
+  const bool avx2 = vectorized && avx2Available();
+
+  if (filter_stars) {
+      // the column is int32; clamp the bounds to it
+      const int64_t lo = std::max<int64_t>(stars_min, std::numeric_limits<int32_t>::min());
+      const int64_t hi = std::min<int64_t>(stars_max, std::numeric_limits<int32_t>::max());
+      if (lo > hi) return Selection(rows, false);
+      selectRange(table.stars().data(), rows, static_cast<int32_t>(lo), static_cast<int32_t>(hi), words, avx2);
+  }
+  if (filter_pushed) {
+      if (pushed_min > pushed_max) return Selection(rows, false);
+      selectRange(table.pushedAt().data(), rows, pushed_min, pushed_max, words, avx2);
+  }
+  if (filter_license) {
+#ifdef TABLE_FILTER_X86
+      if (avx2) {
+          memberAvx2(table.licenses().data(), rows, license_allowed.data(), words);
+      } else
+#endif
+      {
+          memberScalar(table.licenses().data(), rows, license_allowed.data(), words);
+      }
+  }
+  for (const FieldCondition& field : fields) {
+      const std::vector<std::string_view>* column = table.internedColumn(field.path);
+      if (!column) {
+          // no values at all: only != passes
+          if (field.equal) return Selection(rows, false);
+          continue;
+      }
+      fieldScalar(column->data(), rows, field.values, field.equal, words);
+  }
+  return selection;
+}
@@ -0,0 +1,74 @@
+#ifndef TABLE_FILTER_H
+#define TABLE_FILTER_H
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "project_table.h"
+
+// Client-side filter over a ProjectTable, as given to --where: comma
+// separated conditions that all have to hold, e.g.
+//   stars>=100,stars<5000,pushed>=2024-01-01,license=MIT|Apache-2.0
+// stars and pushed take = < <= > >=; pushed compares with a date, an
+// ISO-8601 timestamp or Nd, N days ago. A date is its whole UTC day:
+// pushed=2024-01-01 is any push that day, pushed<=2024-01-01 includes it and
+// pushed>2024-01-01 starts the day after. license takes = and != with SPDX ids
+// separated by |, plus none, noassertion and other. Conditions on the same
+// column narrow each other. Extra fields the table interns (language,
+// owner.login, ... see SearchFields::repeats) take = and != with exact
+// values separated by |, e.g. language=C++|Rust; those values are interned
+// at parse time, so a row is tested with pointer compares.
+//
+// Each column is scanned once, 64 rows per selection word, with branch-free
+// range and set-membership tests (AVX2 compares where the CPU has them), so a
+// million rows take a few milliseconds.
+class TableFilter {
+public:
+    // False with error set when text isn't a filter.
+    // Field values are interned into interner, which has to be the table's.
+    static bool parse(const std::string& text, TableFilter& filter, std::string& error,
+                      StringInterner& interner = StringInterner::global());
+
+    bool empty() const { return !filter_stars && !filter_pushed && !filter_license && fields.empty(); }
+
+    // Extra field paths the conditions look at; a table without one of them
+    // has no row with a value for it.
+    std::vector<std::string> fieldPaths() const;
+
+    // Rows matching every condition. vectorized = false sticks to the scalar loops.
+    Selection select(const ProjectTable& table, bool vectorized = true) const;
+
+    // Whether select() can use AVX2 on this CPU.
+    static bool avx2Available();
+
+    // One row at a time, for a ProjectInfo or ProjectInfoView; checks
+    // stars, pushed and license only.
+    template <typename Row>
+    bool matches(const Row& row) const {
+        return (!filter_stars || (row.stargazers_count >= stars_min && row.stargazers_count <= stars_max)) &&
+               (!filter_pushed || (row.pushed_at >= pushed_min && row.pushed_at <= pushed_max)) &&
+               (!filter_license || license_allowed[static_cast<size_t>(row.license)]);
+    }
+
+private:
+    bool filter_stars = false;
+    int64_t stars_min = std::numeric_limits<int64_t>::min();
+    int64_t stars_max = std::numeric_limits<int64_t>::max();
+    bool filter_pushed = false;
+    int64_t pushed_min = std::numeric_limits<int64_t>::min() + 1;  // rows without a push never match
+    int64_t pushed_max = std::numeric_limits<int64_t>::max();
+    bool filter_license = false;
+    std::array<uint8_t, 256> license_allowed{};  // 1 for each SpdxLicense that passes
+
+    struct FieldCondition {
+        std::string path;
+        bool equal = true;                    // = rather than !=
+        std::vector<std::string_view> values;  // interned
+    };
+    std::vector<FieldCondition> fields;
+};
+
+#endif
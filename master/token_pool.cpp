@@ -0,0 +1,106 @@
+#include "token_pool.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <sstream>
+#include <thread>
+
+TokenPool::TokenPool(std::vector<std::string> tokens) {
+  if (tokens.empty()) tokens.push_back("");
+  for (std::string& token : tokens) {
+      std::shared_ptr<RateLimitScheduler> scheduler = RateLimitScheduler::forToken(token);
+      entries.push_back(Entry{std::move(token), std::move(scheduler)});
+  }
+}
+
+std::vector<std::string> TokenPool::tokensFromEnvironment() {
+  std::vector<std::string> tokens;
+  auto add = [&tokens](std::string token) {
+      token.erase(0, token.find_first_not_of(" \t\r\n"));
+      token.erase(token.find_last_not_of(" \t\r\n") + 1);
+      if (!token.empty() && std::find(tokens.begin(), tokens.end(), token) == tokens.end()) {
+          tokens.push_back(token);
+      }
+  };
+
+  if (const char* list = std::getenv("GITHUB_TOKENS")) {
+      std::istringstream is_list(list);
+      std::string token;
+      while (std::getline(is_list, token, ',')) add(token);
+  }
+  for (int i = 1;; ++i) {
+      const char* token = std::getenv(("GITHUB_TOKEN_" + std::to_string(i)).c_str());
+      if (!token) break;
+      add(token);
+  }
+  if (const char* token = std::getenv("GITHUB_TOKEN")) add(token);
+  return tokens;
+}
+
+RateLimitScheduler::Clock::duration TokenPool::reserve(const std::string& resource, size_t& index_out) {
+  // most remaining budget first; a token that hasn't reported yet counts as full
+  std::vector<std::pair<long, size_t>> order;
+  {
+      std::lock_guard<std::mutex> lock(mutex);
+      const size_t start = rotation++ % entries.size();
+      for (size_t n = 0; n < entries.size(); ++n) {
+          const size_t i = (start + n) % entries.size();
+          long remaining = entries[i].scheduler->budget(resource).remaining;
+          order.emplace_back(remaining < 0 ? LONG_MAX : remaining, i);
+      }
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [](const std::pair<long, size_t>& a, const std::pair<long, size_t>& b) { return a.first > b.first; });
+
+  RateLimitScheduler::Clock::duration shortest = RateLimitScheduler::Clock::duration::max();
+  for (const auto& candidate : order) {
+      auto wait = entries[candidate.second].scheduler->reserve(resource);
+      if (wait == RateLimitScheduler::Clock::duration::zero()) {
+          index_out = candidate.second;
+          return wait;
+      }
+      shortest = std::min(shortest, wait);
+  }
+  return shortest;
+}
+
+size_t TokenPool::acquire(const std::string& resource) {
+  size_t index = 0;
+  for (;;) {
+      auto wait = reserve(resource, index);
+      if (wait == RateLimitScheduler::Clock::duration::zero()) return index;
+      std::this_thread::sleep_for(wait);
+  }
+}
+
+void TokenPool::update(size_t index, const std::string& resource, const HttpHeaders& headers, long http_code) {
+  if (index < entries.size()) entries[index].scheduler->update(resource, headers, http_code);
+}
+
+RateLimitScheduler::Budget TokenPool::budget(size_t index, const std::string& resource) const {
+  return index < entries.size() ? entries[index].scheduler->budget(resource) : RateLimitScheduler::Budget{};
+}
+
+RateLimitScheduler::Budget TokenPool::budget(const std::string& resource) const {
+  RateLimitScheduler::Budget total;
+  for (const Entry& entry : entries) {
+      RateLimitScheduler::Budget budget = entry.scheduler->budget(resource);
+      if (budget.remaining < 0) continue;
+      total.limit = (total.limit < 0 ? 0 : total.limit) + std::max(0L, budget.limit);
+      total.remaining = (total.remaining < 0 ? 0 : total.remaining) + budget.remaining;
+      if (budget.reset > 0 && (total.reset == 0 || budget.reset < total.reset)) total.reset = budget.reset;
+  }
+  return total;
+}
+
+RateLimitScheduler::Stats TokenPool::stats() const {
+  RateLimitScheduler::Stats total{0, 0, 0, std::chrono::milliseconds(0)};
+  for (const Entry& entry : entries) {
+      RateLimitScheduler::Stats stats = entry.scheduler->stats();
+      total.requests += stats.requests;
+      total.delayed += stats.delayed;
+      total.rate_limited += stats.rate_limited;
+      total.waited += stats.waited;
+  }
+  return total;
+}
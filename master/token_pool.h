@@ -0,0 +1,57 @@
+#ifndef TOKEN_POOL_H
+#define TOKEN_POOL_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "http_headers.h"
+#include "rate_limit_scheduler.h"
+
+// A set of GitHub tokens, each with its own rate-limit budget. Every request
+// is routed to the token with the most headroom left for its resource, so
+// throughput grows with the number of tokens instead of being capped by one
+// token's quota. Thread-safe.
+class TokenPool {
+public:
+    // An empty list (or a list of one empty string) means unauthenticated.
+    explicit TokenPool(std::vector<std::string> tokens = {});
+
+    // Tokens configured in the environment (after loadDotEnv): the comma
+    // separated GITHUB_TOKENS, GITHUB_TOKEN_1..GITHUB_TOKEN_N and GITHUB_TOKEN,
+    // in that order, without duplicates.
+    static std::vector<std::string> tokensFromEnvironment();
+
+    size_t size() const { return entries.size(); }
+    const std::string& token(size_t index) const { return entries[index].token; }
+
+    // Reserve one request on the token with the most headroom and store its
+    // index. Returns zero on success, otherwise how long until a token frees up.
+    RateLimitScheduler::Clock::duration reserve(const std::string& resource, size_t& index_out);
+
+    // Blocking form of reserve(), returns the token index.
+    size_t acquire(const std::string& resource);
+
+    // Feed a response back to the token it was sent with.
+    void update(size_t index, const std::string& resource, const HttpHeaders& headers, long http_code);
+
+    RateLimitScheduler::Budget budget(size_t index, const std::string& resource) const;
+
+    // Budget summed over all tokens; reset is the earliest one still pending.
+    RateLimitScheduler::Budget budget(const std::string& resource) const;
+
+    // Pacing counters summed over all tokens.
+    RateLimitScheduler::Stats stats() const;
+
+private:
+    struct Entry {
+        std::string token;
+        std::shared_ptr<RateLimitScheduler> scheduler;
+    };
+
+    std::vector<Entry> entries;
+    mutable std::mutex mutex;
+    size_t rotation = 0;  // spreads requests over tokens whose budgets tie
+};
+
+#endif